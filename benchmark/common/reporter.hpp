@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace crossbow {
+namespace benchmark {
+
+/**
+ * @brief Measurement of a single benchmark operation
+ *
+ * Items are the unit of work of the benchmark (e.g. objects, messages or strings), bytes the amount of data processed
+ * by one run (0 if not applicable).
+ */
+struct Result {
+    const char* benchmark;
+    const char* operation;
+    std::size_t items;
+    std::size_t bytes;
+    double seconds;
+};
+
+/**
+ * @brief Writes benchmark results as CSV (with a header line) or as a JSON array
+ *
+ * Besides the measured values the throughput in MB/s and in items per second is reported.
+ */
+class Reporter {
+public:
+    /**
+     * @param out The stream the results are written to
+     * @param json Whether to write JSON instead of CSV
+     * @param items Name of the items column (e.g. "objects")
+     */
+    Reporter(std::ostream& out, bool json, std::string items)
+            : mOut(out),
+              mJson(json),
+              mItems(std::move(items)),
+              mFirst(true) {
+        if (mJson) {
+            mOut << "[" << std::endl;
+        } else {
+            mOut << "benchmark,operation," << mItems << ",bytes,seconds,mb_per_s," << mItems << "_per_s" << std::endl;
+        }
+    }
+
+    ~Reporter() {
+        if (mJson) {
+            mOut << std::endl << "]" << std::endl;
+        }
+    }
+
+    void report(const Result& r) {
+        auto mbPerSecond = static_cast<double>(r.bytes) / (1024.0 * 1024.0) / r.seconds;
+        auto itemsPerSecond = static_cast<double>(r.items) / r.seconds;
+        if (mJson) {
+            if (!mFirst) {
+                mOut << "," << std::endl;
+            }
+            mOut << "  {\"benchmark\": \"" << r.benchmark << "\", \"operation\": \"" << r.operation
+                 << "\", \"" << mItems << "\": " << r.items << ", \"bytes\": " << r.bytes
+                 << ", \"seconds\": " << r.seconds << ", \"mb_per_s\": " << mbPerSecond
+                 << ", \"" << mItems << "_per_s\": " << itemsPerSecond << "}";
+        } else {
+            mOut << r.benchmark << "," << r.operation << "," << r.items << "," << r.bytes << "," << r.seconds << ","
+                 << mbPerSecond << "," << itemsPerSecond << std::endl;
+        }
+        mFirst = false;
+    }
+
+private:
+    std::ostream& mOut;
+    bool mJson;
+    std::string mItems;
+    bool mFirst;
+};
+
+/**
+ * @brief Executes fun the given number of times and returns the fastest run in seconds
+ */
+template<typename Fun>
+double measure(unsigned iterations, Fun fun) {
+    double best = 0.0;
+    for (unsigned i = 0; i < iterations; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        fun();
+        auto end = std::chrono::steady_clock::now();
+        auto seconds = std::chrono::duration<double>(end - begin).count();
+        if (i == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+} // namespace benchmark
+} // namespace crossbow
@@ -0,0 +1,179 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "common/reporter.hpp"
+
+#include <crossbow/logger.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <boost/format.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+#include <unistd.h>
+
+using namespace crossbow::program_options;
+using namespace crossbow::benchmark;
+
+namespace {
+
+/**
+ * @brief Stream buffer discarding everything written to it
+ */
+class NullBuffer : public std::streambuf {
+public:
+    std::size_t bytes = 0;
+
+protected:
+    virtual int_type overflow(int_type c) override {
+        ++bytes;
+        return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char_type*, std::streamsize n) override {
+        bytes += static_cast<std::size_t>(n);
+        return n;
+    }
+};
+
+const char* FORMAT = "Request %1% from %2% completed in %3% ms with status %4%";
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    std::size_t messages = 1000000;
+    unsigned iterations = 5;
+    bool json = false;
+    bool help = false;
+    auto opts = create_options("logger_benchmark",
+            value<'h'>("help", &help, tag::description{"Print help"}),
+            value<'n'>("messages", &messages, tag::description{"Number of messages per benchmark"}),
+            value<'i'>("iterations", &iterations, tag::description{"Number of iterations (fastest is reported)"}),
+            value<'j'>("json", &json, tag::description{"Print results as JSON instead of CSV"}));
+    try {
+        parse(opts, argc, argv);
+    } catch (const crossbow::program_options::parse_error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    NullBuffer buffer;
+    std::ostream null(&buffer);
+    std::string peer("10.0.0.1:7000");
+
+    Reporter reporter(std::cout, json, "messages");
+
+    // Formatting only
+    buffer.bytes = 0;
+    auto seconds = measure(iterations, [&]() {
+        for (std::size_t i = 0; i < messages; ++i) {
+            boost::format formatter(FORMAT);
+            formatter % i % peer % (i * 0.125) % static_cast<int>(i & 0xFF);
+            null << formatter.str();
+        }
+    });
+    reporter.report(Result{"format", "boost", messages, buffer.bytes / iterations, seconds});
+
+    buffer.bytes = 0;
+    seconds = measure(iterations, [&]() {
+        auto& out = crossbow::logger::impl::threadBuffer();
+        for (std::size_t i = 0; i < messages; ++i) {
+            out.clear();
+            crossbow::logger::impl::format(out, FORMAT, i, peer, i * 0.125, static_cast<int>(i & 0xFF));
+            null.write(out.data(), static_cast<std::streamsize>(out.size()));
+        }
+    });
+    reporter.report(Result{"format", "crossbow", messages, buffer.bytes / iterations, seconds});
+
+    // Complete logging path
+    auto& config = crossbow::logger::logger->config;
+    config.level = crossbow::logger::LogLevel::INFO;
+    config.infoOut = &null;
+
+    buffer.bytes = 0;
+    seconds = measure(iterations, [&]() {
+        for (std::size_t i = 0; i < messages; ++i) {
+            LOG_INFO("Request %1% from %2% completed in %3% ms with status %4%", i, peer, i * 0.125,
+                    static_cast<int>(i & 0xFF));
+        }
+    });
+    reporter.report(Result{"log", "sync", messages, buffer.bytes / iterations, seconds});
+
+    buffer.bytes = 0;
+    seconds = measure(iterations, [&]() {
+        crossbow::logger::logger->startAsync();
+        for (std::size_t i = 0; i < messages; ++i) {
+            LOG_INFO("Request %1% from %2% completed in %3% ms with status %4%", i, peer, i * 0.125,
+                    static_cast<int>(i & 0xFF));
+        }
+        crossbow::logger::logger->stopAsync();
+    });
+    reporter.report(Result{"log", "async", messages, buffer.bytes / iterations, seconds});
+
+    {
+        char dir[] = "/tmp/crossbow_logger_benchmarkXXXXXX";
+        if (mkdtemp(dir) == nullptr) {
+            std::cerr << "Unable to create temporary directory" << std::endl;
+            return 1;
+        }
+        auto path = std::string(dir) + "/log";
+        auto sink = std::make_shared<crossbow::logger::BinaryLogSink>(path, 64 * 1024 * 1024, 1);
+        crossbow::logger::logger->setBinarySink(sink);
+        seconds = measure(iterations, [&]() {
+            for (std::size_t i = 0; i < messages; ++i) {
+                BINLOG_INFO("Request %1% from %2% completed in %3% ms with status %4%", i, peer, i * 0.125,
+                        static_cast<int>(i & 0xFF));
+            }
+        });
+        crossbow::logger::logger->setBinarySink(nullptr);
+        auto current = sink->currentFile();
+        sink.reset();
+        unlink(current.c_str());
+        rmdir(dir);
+        reporter.report(Result{"log", "binary", messages, 0, seconds});
+    }
+
+    buffer.bytes = 0;
+    seconds = measure(iterations, [&]() {
+        for (std::size_t i = 0; i < messages; ++i) {
+            LOG_DEBUG("Request %1% from %2% completed in %3% ms with status %4%", i, peer, i * 0.125,
+                    static_cast<int>(i & 0xFF));
+        }
+    });
+    reporter.report(Result{"log", "disabled", messages, buffer.bytes / iterations, seconds});
+
+    config.infoOut = &std::cout;
+    return 0;
+}
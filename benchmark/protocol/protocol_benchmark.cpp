@@ -0,0 +1,232 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/program_options.hpp>
+#include <crossbow/protocol/ShardedServer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::program_options;
+
+GEN_COMMANDS(Cmd, (REPEAT, PING));
+
+template<Cmd C>
+struct Signature;
+
+template<>
+struct Signature<Cmd::REPEAT> {
+    using arguments = std::string;
+    using result = std::string;
+};
+
+template<>
+struct Signature<Cmd::PING> {
+    using arguments = void;
+    using result = void;
+};
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+struct Implementation {
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::REPEAT>::type execute(const std::string& args, const Callback& callback) {
+        callback(args);
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::PING>::type execute(const Callback& callback) {
+        callback();
+    }
+
+    void close() {
+    }
+};
+
+using ShardedServer = crossbow::protocol::ShardedServer<Cmd_Switch, Cmd, Signature, Implementation>;
+using Client = crossbow::protocol::Client<Cmd, Signature>;
+
+/**
+ * @brief Connection keeping a fixed number of requests in flight until the deadline
+ */
+class Connection {
+public:
+    Connection(boost::asio::io_service& service, const boost::asio::ip::tcp::endpoint& endpoint,
+            const std::string& payload, clock::time_point deadline, std::vector<uint64_t>& latencies)
+        : mSocket(service),
+          mPayload(payload),
+          mDeadline(deadline),
+          mLatencies(latencies),
+          mOutstanding(0) {
+        mSocket.connect(endpoint);
+        mSocket.set_option(boost::asio::ip::tcp::no_delay(true));
+        mClient.reset(new Client(mSocket));
+    }
+
+    void start(size_t depth) {
+        for (size_t i = 0; i < depth; ++i) {
+            issue();
+        }
+    }
+
+    bool done() const {
+        return mOutstanding == 0;
+    }
+
+private:
+    void issue() {
+        ++mOutstanding;
+        auto begin = clock::now();
+        mClient->execute<Cmd::REPEAT>([this, begin](const boost::system::error_code& ec, const std::string&) {
+            --mOutstanding;
+            if (ec) {
+                std::cerr << ec.message() << std::endl;
+                return;
+            }
+            auto end = clock::now();
+            if (end >= mDeadline) {
+                return;
+            }
+            mLatencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+            issue();
+        }, mPayload);
+    }
+
+    boost::asio::ip::tcp::socket mSocket;
+    std::unique_ptr<Client> mClient;
+    const std::string& mPayload;
+    clock::time_point mDeadline;
+    std::vector<uint64_t>& mLatencies;
+    size_t mOutstanding;
+};
+
+double percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]) / 1000.0;
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    size_t serverThreads = 2;
+    size_t clientThreads = 2;
+    size_t connections = 8;
+    size_t depth = 16;
+    size_t payloadSize = 64;
+    unsigned seconds = 5;
+    bool reusePort = false;
+    bool json = false;
+    bool help = false;
+    auto opts = create_options("protocol_benchmark",
+            value<'h'>("help", &help, tag::description{"Print help"}),
+            value<'t'>("server-threads", &serverThreads, tag::description{"Number of server io_service threads"}),
+            value<'T'>("client-threads", &clientThreads, tag::description{"Number of client threads"}),
+            value<'c'>("connections", &connections, tag::description{"Number of connections"}),
+            value<'d'>("depth", &depth, tag::description{"Requests in flight per connection"}),
+            value<'p'>("payload", &payloadSize, tag::description{"Payload size of a request in bytes"}),
+            value<'s'>("seconds", &seconds, tag::description{"Duration of the benchmark"}),
+            value<'r'>("reuse-port", &reusePort, tag::description{"Accept on every server thread with SO_REUSEPORT"}),
+            value<'j'>("json", &json, tag::description{"Print results as JSON instead of CSV"}));
+    try {
+        parse(opts, argc, argv);
+    } catch (const crossbow::program_options::parse_error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    clientThreads = std::max(std::min(clientThreads, connections), size_t(1));
+
+    ShardedServer server(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0), serverThreads,
+            [] (size_t) {
+                return std::unique_ptr<Implementation>(new Implementation());
+            }, reusePort);
+    server.start();
+
+    std::string payload(payloadSize, 'x');
+    auto begin = clock::now();
+    auto deadline = begin + std::chrono::seconds(seconds);
+    std::vector<std::vector<uint64_t>> latencies(clientThreads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < clientThreads; ++i) {
+        threads.emplace_back([i, clientThreads, connections, depth, deadline, &server, &payload, &latencies] () {
+            boost::asio::io_service service;
+            std::vector<std::unique_ptr<Connection>> conns;
+            for (size_t j = i; j < connections; j += clientThreads) {
+                conns.emplace_back(new Connection(service, server.localEndpoint(), payload, deadline, latencies[i]));
+                conns.back()->start(depth);
+            }
+            auto done = [&conns] () {
+                return std::all_of(conns.begin(), conns.end(), [] (const std::unique_ptr<Connection>& c) {
+                    return c->done();
+                });
+            };
+            while (!done()) {
+                service.run_one();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::min(clock::now(), deadline) - begin).count();
+    server.stop();
+
+    std::vector<uint64_t> all;
+    for (auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto requestsPerSecond = static_cast<double>(all.size()) / elapsed;
+
+    if (json) {
+        std::cout << "{\"benchmark\": \"protocol\", \"server_threads\": " << serverThreads
+                  << ", \"connections\": " << connections << ", \"depth\": " << depth
+                  << ", \"payload\": " << payloadSize << ", \"requests\": " << all.size()
+                  << ", \"seconds\": " << elapsed << ", \"requests_per_s\": " << requestsPerSecond
+                  << ", \"p50_us\": " << percentile(all, 0.5) << ", \"p90_us\": " << percentile(all, 0.9)
+                  << ", \"p99_us\": " << percentile(all, 0.99) << ", \"p999_us\": " << percentile(all, 0.999)
+                  << "}" << std::endl;
+    } else {
+        std::cout << "benchmark,server_threads,connections,depth,payload,requests,seconds,requests_per_s,"
+                  << "p50_us,p90_us,p99_us,p999_us" << std::endl;
+        std::cout << "protocol," << serverThreads << "," << connections << "," << depth << "," << payloadSize << ","
+                  << all.size() << "," << elapsed << "," << requestsPerSecond << "," << percentile(all, 0.5) << ","
+                  << percentile(all, 0.9) << "," << percentile(all, 0.99) << "," << percentile(all, 0.999)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "common/reporter.hpp"
+
+#include <crossbow/program_options.hpp>
+#include <crossbow/Serializer.hpp>
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace crossbow::benchmark;
+
+namespace {
+
+volatile std::size_t gSink = 0;
+
+struct Point {
+    uint64_t id;
+    double x;
+    double y;
+    uint32_t flags;
+    uint32_t tag;
+};
+
+using Nested = std::map<uint64_t, std::unordered_map<std::string, uint32_t>>;
+using Tuple = std::tuple<uint32_t, std::string, double>;
+
+/**
+ * @brief Benchmarks sizer, serialize and deserialize on the object and a memcpy of the serialized data as baseline
+ *
+ * Throughput is computed from the serialized size of the object.
+ */
+template<typename T>
+void run(Reporter& reporter, unsigned iterations, const char* name, const T& obj, std::size_t objects) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto bytes = crossbow::serialize(buffer, obj);
+
+    auto seconds = measure(iterations, [&obj] () {
+        crossbow::sizer s;
+        s & obj;
+        gSink = gSink + s.size;
+    });
+    reporter.report(Result{name, "size", objects, bytes, seconds});
+
+    seconds = measure(iterations, [&obj] () {
+        std::unique_ptr<uint8_t[]> res;
+        gSink = gSink + crossbow::serialize(res, obj);
+    });
+    reporter.report(Result{name, "serialize", objects, bytes, seconds});
+
+    seconds = measure(iterations, [&buffer] () {
+        T res;
+        crossbow::deserialize(res, buffer.get());
+        gSink = gSink + res.size();
+    });
+    reporter.report(Result{name, "deserialize", objects, bytes, seconds});
+
+    std::unique_ptr<uint8_t[]> target(new uint8_t[bytes]);
+    seconds = measure(iterations, [&buffer, &target, bytes] () {
+        memcpy(target.get(), buffer.get(), bytes);
+        gSink = gSink + target[bytes - 1];
+    });
+    reporter.report(Result{name, "memcpy", objects, bytes, seconds});
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    std::size_t objects = 1000000;
+    unsigned iterations = 5;
+    bool json = false;
+    bool help = false;
+    auto opts = create_options("serializer_benchmark",
+            value<'h'>("help", &help, tag::description{"Print help"}),
+            value<'n'>("objects", &objects, tag::description{"Number of objects per benchmark"}),
+            value<'i'>("iterations", &iterations, tag::description{"Number of iterations (fastest is reported)"}),
+            value<'j'>("json", &json, tag::description{"Print results as JSON instead of CSV"}));
+    try {
+        parse(opts, argc, argv);
+    } catch (const crossbow::program_options::parse_error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    Reporter reporter(std::cout, json, "objects");
+    {
+        std::vector<Point> v;
+        v.reserve(objects);
+        for (std::size_t i = 0; i < objects; ++i) {
+            v.emplace_back(Point{i, i * 0.5, i * 1.5, static_cast<uint32_t>(i), 42u});
+        }
+        run(reporter, iterations, "pod", v, objects);
+    }
+    {
+        std::vector<uint64_t> v(objects);
+        for (std::size_t i = 0; i < objects; ++i) {
+            v[i] = i;
+        }
+        run(reporter, iterations, "vector", v, objects);
+    }
+    {
+        std::vector<std::string> v;
+        v.reserve(objects);
+        for (std::size_t i = 0; i < objects; ++i) {
+            v.emplace_back(8 + i % 57, 'a' + (i % 26));
+        }
+        run(reporter, iterations, "string", v, objects);
+    }
+    {
+        Nested m;
+        for (std::size_t i = 0; i < objects; ++i) {
+            m[i / 16].emplace(std::to_string(i), static_cast<uint32_t>(i));
+        }
+        run(reporter, iterations, "nested_map", m, objects);
+    }
+    {
+        std::vector<Tuple> v;
+        v.reserve(objects);
+        for (std::size_t i = 0; i < objects; ++i) {
+            v.emplace_back(static_cast<uint32_t>(i), std::to_string(i), i * 0.25);
+        }
+        run(reporter, iterations, "tuple", v, objects);
+    }
+    {
+        std::vector<boost::optional<uint64_t>> v;
+        v.reserve(objects);
+        for (std::size_t i = 0; i < objects; ++i) {
+            v.emplace_back(i % 3 == 0 ? boost::optional<uint64_t>() : boost::optional<uint64_t>(i));
+        }
+        run(reporter, iterations, "optional", v, objects);
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include "common/reporter.hpp"
+
+#include <crossbow/interned_string.hpp>
+#include <crossbow/program_options.hpp>
+#include <crossbow/string.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace crossbow::program_options;
+using namespace crossbow::benchmark;
+
+namespace {
+
+volatile std::size_t gSink = 0;
+
+/**
+ * @brief The byte wise hash previously used by crossbow::hash_value
+ */
+std::size_t legacyHash(const crossbow::string& str) {
+    constexpr std::size_t FNV_offset_basis = 14695981039346656037ul;
+    auto hash = FNV_offset_basis;
+    for (auto i = str.begin(); i != str.end(); ++i) {
+        hash *= FNV_offset_basis;
+        hash ^= std::size_t(*i);
+    }
+    return hash;
+}
+
+template<typename String>
+std::vector<String> generate(std::size_t count, std::size_t length) {
+    std::vector<String> res;
+    res.reserve(count);
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    std::string s(length, ' ');
+    for (std::size_t i = 0; i < count; ++i) {
+        for (auto& c : s) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            c = static_cast<char>('a' + state % 26);
+        }
+        res.emplace_back(s.c_str());
+    }
+    return res;
+}
+
+void run(Reporter& reporter, unsigned iterations, std::size_t strings, std::size_t length) {
+    auto keys = generate<crossbow::string>(strings, length);
+    auto stdKeys = generate<std::string>(strings, length);
+
+    auto seconds = measure(iterations, [&keys]() {
+        for (auto& key : keys) {
+            gSink = gSink + legacyHash(key);
+        }
+    });
+    reporter.report(Result{"legacy", "hash", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys]() {
+        for (auto& key : keys) {
+            gSink = gSink + crossbow::hash_value(key);
+        }
+    });
+    reporter.report(Result{"crossbow", "hash", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&stdKeys]() {
+        std::hash<std::string> hash;
+        for (auto& key : stdKeys) {
+            gSink = gSink + hash(key);
+        }
+    });
+    reporter.report(Result{"std", "hash", strings, strings * length, seconds});
+
+    std::unordered_map<crossbow::string, std::size_t> map;
+    map.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.emplace(keys[i], i);
+    }
+    seconds = measure(iterations, [&keys, &map]() {
+        for (auto& key : keys) {
+            gSink = gSink + map.find(key)->second;
+        }
+    });
+    reporter.report(Result{"crossbow", "lookup", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys]() {
+        for (auto& key : keys) {
+            gSink = gSink + crossbow::interned_string(key).size();
+        }
+    });
+    reporter.report(Result{"interned", "intern", strings, strings * length, seconds});
+
+    std::vector<crossbow::interned_string> internedKeys(keys.begin(), keys.end());
+    std::unordered_map<crossbow::interned_string, std::size_t> internedMap;
+    internedMap.reserve(internedKeys.size());
+    for (std::size_t i = 0; i < internedKeys.size(); ++i) {
+        internedMap.emplace(internedKeys[i], i);
+    }
+    seconds = measure(iterations, [&internedKeys, &internedMap]() {
+        for (auto& key : internedKeys) {
+            gSink = gSink + internedMap.find(key)->second;
+        }
+    });
+    reporter.report(Result{"interned", "lookup", strings, strings * length, seconds});
+}
+
+/**
+ * @brief Benchmarks the basic accessors and operations dominated by the small string layout
+ */
+template<typename String>
+void runLayout(Reporter& reporter, const char* benchmark, unsigned iterations, std::size_t strings,
+        std::size_t length) {
+    auto keys = generate<String>(strings, length);
+
+    auto seconds = measure(iterations, [&keys]() {
+        std::size_t sum = 0;
+        for (auto& key : keys) {
+            sum += key.size();
+        }
+        gSink = gSink + sum;
+    });
+    reporter.report(Result{benchmark, "size", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys]() {
+        std::size_t sum = 0;
+        for (auto& key : keys) {
+            sum += static_cast<unsigned char>(key.data()[0]);
+        }
+        gSink = gSink + sum;
+    });
+    reporter.report(Result{benchmark, "data", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys]() {
+        std::size_t sum = 0;
+        for (std::size_t i = 1; i < keys.size(); ++i) {
+            sum += (keys[i - 1].compare(keys[i]) < 0);
+        }
+        gSink = gSink + sum;
+    });
+    reporter.report(Result{benchmark, "compare", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys, length]() {
+        std::size_t sum = 0;
+        for (auto& key : keys) {
+            String str;
+            for (std::size_t i = 0; i < length; ++i) {
+                str.push_back(key[i]);
+            }
+            sum += str.size();
+        }
+        gSink = gSink + sum;
+    });
+    reporter.report(Result{benchmark, "append", strings, strings * length, seconds});
+
+    seconds = measure(iterations, [&keys]() {
+        std::size_t sum = 0;
+        for (auto& key : keys) {
+            String str(key);
+            sum += str.size();
+        }
+        gSink = gSink + sum;
+    });
+    reporter.report(Result{benchmark, "copy", strings, strings * length, seconds});
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv) {
+    std::size_t strings = 1000000;
+    unsigned iterations = 5;
+    bool json = false;
+    bool help = false;
+    auto opts = create_options("string_benchmark",
+            value<'h'>("help", &help, tag::description{"Print help"}),
+            value<'n'>("strings", &strings, tag::description{"Number of strings per benchmark"}),
+            value<'i'>("iterations", &iterations, tag::description{"Number of iterations (fastest is reported)"}),
+            value<'j'>("json", &json, tag::description{"Print results as JSON instead of CSV"}));
+    try {
+        parse(opts, argc, argv);
+    } catch (const crossbow::program_options::parse_error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help) {
+        print_help(std::cout, opts);
+        return 0;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    Reporter reporter(std::cout, json, "strings");
+    for (std::size_t length : {8, 16, 30, 31, 64, 256, 4096}) {
+        auto count = (length > 256 ? strings / 16 : strings);
+        run(reporter, iterations, count, length);
+        runLayout<crossbow::string>(reporter, "crossbow", iterations, count, length);
+        runLayout<std::string>(reporter, "std", iterations, count, length);
+    }
+    return 0;
+}
@@ -28,19 +28,33 @@
  * or nested types derived from structs or vectors using crossbow::serializable as a
  * serialization method. This serialization method then creates message buffers in the
  * form of:
- * |8 bytes: total buffer size|4 bytes: command-id (>= 1)|command args ...|
+ * |8 bytes: total buffer size|8 bytes: request-id|4 bytes: command-id (>= 1)|command args ...|
  *
+ * Responses are sent in the form of:
+ * |8 bytes: total buffer size|8 bytes: request-id|result ...|
+ *
+ * where the result is empty for commands returning void. The request-id is chosen by the client and allows multiple
+ * requests to be in flight on the same connection, the responses are matched to the requests by their id.
  */
 #pragma once
 #include <tuple>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
 #include <type_traits>
+#include <unordered_map>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio.hpp>
+#include <boost/version.hpp>
 #include <boost/preprocessor.hpp>
 
 #include <crossbow/Serializer.hpp>
+#include <crossbow/protocol/BufferPool.hpp>
+#include <crossbow/protocol/FramedReader.hpp>
+#include <crossbow/protocol/WriteQueue.hpp>
 #include <crossbow/string.hpp>
 
 #define GEN_CASE(r, data, elem)\
@@ -93,8 +107,21 @@ struct ArgSerializer<> {
     void exec(C&) const {}
 };
 
+inline boost::asio::io_service& getIoService(boost::asio::ip::tcp::socket& socket) {
+#if BOOST_VERSION >= 107000
+    return static_cast<boost::asio::io_service&>(socket.get_executor().context());
+#else
+    return socket.get_io_service();
+#endif
+}
+
 } // namespace impl
 
+/**
+ * @brief Size of the header in front of every request and response (total size and request id)
+ */
+constexpr size_t HEADER_SIZE = sizeof(size_t) + sizeof(uint64_t);
+
 template<class... Args>
 struct argsType;
 template<class A, class B, class... Tail>
@@ -111,74 +138,46 @@ struct argsType<> {
 };
 
 
+/**
+ * @brief Client issuing commands to a protocol::Server
+ *
+ * Any number of requests can be outstanding on the socket at the same time: Requests are written in the order execute
+ * is called (requests issued in the same handler are sent with a single vectored write) while responses are matched to
+ * the pending requests by their id. The client is not thread safe, all calls
+ * must be made from the thread running the io_service of the socket.
+ */
 template<class Command, template <Command> class Signature>
 class Client {
+    using error_code = boost::system::error_code;
+    using ResponseHandler = std::function<void(const error_code&, const uint8_t*)>;
+
     boost::asio::ip::tcp::socket& mSocket;
-    size_t mCurrSize = 1024;
-    std::unique_ptr<uint8_t[]> mCurrentRequest;
+    BufferPool mPool;
+    FramedReader mReader;
+    WriteQueue mWriteQueue;
+    uint64_t mNextId = 1;
+    std::unordered_map<uint64_t, ResponseHandler> mPending;
 public:
-    Client(boost::asio::ip::tcp::socket& socket)
-        : mSocket(socket), mCurrentRequest(new uint8_t[mCurrSize])
+    /**
+     * @param socket The connected socket
+     * @param maxFrameSize Responses larger than this are rejected
+     */
+    Client(boost::asio::ip::tcp::socket& socket, size_t maxFrameSize = FramedReader::DEFAULT_MAX_FRAME_SIZE)
+        : mSocket(socket)
+        , mReader(socket, mPool, HEADER_SIZE, [this](const error_code& ec, const uint8_t* frame, size_t) {
+            return onResponse(ec, frame);
+        }, 64 * 1024, maxFrameSize)
+        , mWriteQueue(impl::getIoService(socket), socket, mPool, [this](const error_code& ec) {
+            error(ec);
+        })
     {
     }
 
-    template<class Callback, class Result>
-    typename std::enable_if<std::is_void<Result>::value, void>::type
-    readResponse(const Callback& callback, size_t bytes_read = 0) {
-        assert(bytes_read <= 1);
-        if (bytes_read) {
-            boost::system::error_code noError;
-            callback(noError);
-        }
-        mSocket.async_read_some(boost::asio::buffer(mCurrentRequest.get(), mCurrSize),
-                [this, callback, bytes_read](const boost::system::error_code& ec, size_t br){
-                    if (ec) {
-                        error<Result>(ec, callback);
-                        return;
-                    }
-                    readResponse<Callback, Result>(callback, bytes_read + br);
-                });
-    }
-
-    template<class Callback, class Result>
-    typename std::enable_if<!std::is_void<Result>::value, void>::type
-    readResponse(const Callback& callback, size_t bytes_read = 0) {
-        auto respSize = *reinterpret_cast<size_t*>(mCurrentRequest.get());
-        if (bytes_read >= 8 && respSize == bytes_read) {
-            // response read
-            Result res;
-            boost::system::error_code noError;
-            crossbow::deserializer ser(mCurrentRequest.get() + sizeof(size_t));
-            ser & res;
-            callback(noError, res);
-            return;
-        } else if (bytes_read >= 8 && respSize > mCurrSize) {
-            std::unique_ptr<uint8_t[]> newBuf(new uint8_t[respSize]);
-            memcpy(newBuf.get(), mCurrentRequest.get(), mCurrSize);
-            mCurrentRequest.swap(newBuf);
-        }
-        mSocket.async_read_some(boost::asio::buffer(mCurrentRequest.get() + bytes_read, mCurrSize - bytes_read),
-                [this, callback, bytes_read](const boost::system::error_code& ec, size_t br){
-                    if (ec) {
-                        Result res;
-                        callback(ec, res);
-                        return;
-                    }
-                    readResponse<Callback, Result>(callback, bytes_read + br);
-                });
-    }
-
-    template<class Res, class Callback>
-    typename std::enable_if<std::is_void<Res>::value, void>::type
-    error(const boost::system::error_code& ec, const Callback& callback) {
-        callback(ec);
-    }
-
-    template<class Res, class Callback>
-    typename std::enable_if<!std::is_void<Res>::value, void>::type
-    error(const boost::system::error_code& ec, const Callback& callback) {
-        Res res;
-        callback(ec, res);
+    /**
+     * @brief Number of requests waiting for a response
+     */
+    size_t pending() const {
+        return mPending.size();
     }
 
     template<Command C, class Callback, class... Args>
@@ -188,52 +187,134 @@ public:
                 std::is_same<typename Signature<C>::arguments, typename argsType<Args...>::type>::value,
                 "Wrong function arguments");
         using ResType = typename Signature<C>::result;
+        auto id = mNextId++;
         crossbow::sizer sizer;
         sizer & sizer.size;
+        sizer & id;
         sizer & C;
         impl::ArgSerializer<Args...> argSerializer;
         argSerializer.exec(sizer, args...);
-        if (mCurrSize < sizer.size) {
-            mCurrentRequest.reset(new uint8_t[sizer.size]);
-            mCurrSize = sizer.size;
-        }
-        crossbow::serializer ser(mCurrentRequest.get());
+        auto request = mPool.acquire(sizer.size);
+        crossbow::serializer_into_array ser(request.data.get());
         ser & sizer.size;
+        ser & id;
         ser & C;
         argSerializer.exec(ser, args...);
-        ser.buffer.release();
-        boost::asio::async_write(mSocket, boost::asio::buffer(mCurrentRequest.get(), sizer.size),
-                    [this, callback](const boost::system::error_code& ec, size_t){
-                        if (ec) {
-                            error<ResType>(ec, callback);
-                            return;
-                        }
-                        readResponse<Callback, ResType>(callback);
-                    });
+
+        mPending.emplace(id, handler<ResType>(callback));
+        mWriteQueue.write(std::move(request), sizer.size);
+        mReader.start();
+    }
+
+private:
+    template<class Res, class Callback>
+    typename std::enable_if<std::is_void<Res>::value, ResponseHandler>::type
+    handler(const Callback& callback) {
+        Callback cb(callback);
+        return [cb](const error_code& ec, const uint8_t*) mutable {
+            cb(ec);
+        };
+    }
+
+    template<class Res, class Callback>
+    typename std::enable_if<!std::is_void<Res>::value, ResponseHandler>::type
+    handler(const Callback& callback) {
+        Callback cb(callback);
+        return [cb](const error_code& ec, const uint8_t* data) mutable {
+            Res res;
+            if (!ec) {
+                crossbow::deserializer des(data);
+                des & res;
+            }
+            cb(ec, res);
+        };
+    }
+
+    /**
+     * @brief Completes all pending requests with the given error
+     */
+    void error(const error_code& ec) {
+        // Callbacks might issue new requests
+        std::unordered_map<uint64_t, ResponseHandler> pending;
+        pending.swap(mPending);
+        for (auto& p : pending) {
+            p.second(ec, nullptr);
+        }
+    }
+
+    bool onResponse(const error_code& ec, const uint8_t* frame) {
+        if (ec) {
+            error(ec);
+            return false;
+        }
+        uint64_t id;
+        memcpy(&id, frame + sizeof(size_t), sizeof(id));
+        auto i = mPending.find(id);
+        if (i == mPending.end()) {
+            mSocket.close();
+            error(boost::system::errc::make_error_code(boost::system::errc::bad_message));
+            return false;
+        }
+        auto handler = std::move(i->second);
+        mPending.erase(i);
+        handler(error_code(), frame + HEADER_SIZE);
+        // Stop reading when no more responses are expected
+        return !mPending.empty();
     }
 };
 
+/**
+ * @brief Server executing the commands received on a socket
+ *
+ * All complete requests received with a single read are executed before the socket is read again. The next request is
+ * read while the responses of previous requests are still being written, responses are queued in the order the
+ * Implementation completes the requests and all queued responses are sent with a single vectored write. The
+ * Implementation must invoke the callbacks on the thread running the io_service of the socket.
+ */
 template<template <typename> class Cmd_Switch,
          class Command,
          template <Command> class Signature,
          class Implementation>
 class Server : public Cmd_Switch<Server<Cmd_Switch, Command, Signature, Implementation>> {
     friend struct Cmd_Switch<Server<Cmd_Switch, Command, Signature, Implementation>>;
+    using error_code = boost::system::error_code;
     Implementation& mImpl;
     boost::asio::ip::tcp::socket& mSocket;
-    size_t mBufSize = 1024;
-    std::unique_ptr<uint8_t[]> mBuffer;
-    using error_code = boost::system::error_code;
+    std::function<void()> mOnClose;
+    BufferPool mPool;
+    FramedReader mReader;
+    WriteQueue mWriteQueue;
+    const uint8_t* mFrame = nullptr;
     bool doQuit = false;
+    bool mClosed = false;
 public:
-    Server(Implementation& impl, boost::asio::ip::tcp::socket& socket)
+    /**
+     * @param impl The implementation executing the commands
+     * @param socket The connected socket
+     * @param onClose Invoked after the connection was closed due to an error
+     * @param maxFrameSize Requests larger than this are rejected and close the connection
+     */
+    Server(Implementation& impl, boost::asio::ip::tcp::socket& socket, std::function<void()> onClose = nullptr,
+            size_t maxFrameSize = FramedReader::DEFAULT_MAX_FRAME_SIZE)
         : mImpl(impl)
         , mSocket(socket)
-        , mBuffer(new uint8_t[mBufSize])
+        , mOnClose(std::move(onClose))
+        , mReader(socket, mPool, HEADER_SIZE + sizeof(Command),
+                [this](const error_code& ec, const uint8_t* frame, size_t) {
+                    return onRequest(ec, frame);
+                }, 64 * 1024, maxFrameSize)
+        , mWriteQueue(impl::getIoService(socket), socket, mPool, [this](const error_code& ec) {
+            close(ec);
+        })
     {}
     void run() {
-        read();
+        mReader.start();
     }
+    /**
+     * @brief Stops the io_service of the socket once the response to the current request was sent
+     *
+     * No further requests are read.
+     */
     void quit() {
         doQuit = true;
     }
@@ -249,91 +330,94 @@ private:
     execute(Callback callback) {
         using Args = typename Signature<C>::arguments;
         Args args;
-        crossbow::deserializer des(mBuffer.get() + sizeof(size_t) + sizeof(Command));
+        crossbow::deserializer des(mFrame + HEADER_SIZE + sizeof(Command));
         des & args;
         mImpl.template execute<C>(args, callback);
     }
 
     template<Command C>
     typename std::enable_if<std::is_void<typename Signature<C>::result>::value, void>::type execute() {
-        execute<C>([this]() {
+        auto id = requestId();
+        execute<C>([this, id]() {
             // send the result back
-            mBuffer[0] = 1;
-            boost::asio::async_write(mSocket,
-                    boost::asio::buffer(mBuffer.get(), 1),
-                    [this](const error_code& ec, size_t bytes_written) {
-                        if (ec) {
-                            std::cerr << ec.message() << std::endl;
-                            return;
-                        }
-                        read(0);
-                    }
-            );
+            auto response = mPool.acquire(HEADER_SIZE);
+            crossbow::serializer_into_array ser(response.data.get());
+            ser & HEADER_SIZE;
+            ser & id;
+            write(std::move(response), HEADER_SIZE);
         });
     }
 
     template<Command C>
     typename std::enable_if<!std::is_void<typename Signature<C>::result>::value, void>::type execute() {
         using Res = typename Signature<C>::result;
-        execute<C>([this](const Res& result) {
+        auto id = requestId();
+        execute<C>([this, id](const Res& result) {
             // Serialize result
             crossbow::sizer sizer;
             sizer & sizer.size;
+            sizer & id;
             sizer & result;
-            if (mBufSize < sizer.size) {
-                mBuffer.reset(new uint8_t[sizer.size]);
-            }
-            crossbow::serializer ser(mBuffer.get());
+            auto response = mPool.acquire(sizer.size);
+            crossbow::serializer_into_array ser(response.data.get());
             ser & sizer.size;
+            ser & id;
             ser & result;
-            ser.buffer.release();
             // send the result back
-            boost::asio::async_write(mSocket,
-                    boost::asio::buffer(mBuffer.get(), sizer.size),
-                    [this](const error_code& ec, size_t bytes_written) {
-                        if (ec) {
-                            std::cerr << ec.message() << std::endl;
-                            mSocket.close();
-                            mImpl.close();
-                            return;
-                        }
-                        read(0);
-                    }
-            );
+            write(std::move(response), sizer.size);
         });
     }
-    void read(size_t bytes_read = 0) {
-        if (bytes_read == 0 && doQuit) {
-            mSocket.get_io_service().stop();
+
+    uint64_t requestId() const {
+        uint64_t id;
+        memcpy(&id, mFrame + sizeof(size_t), sizeof(id));
+        return id;
+    }
+
+    bool onRequest(const error_code& ec, const uint8_t* frame) {
+        if (ec) {
+            close(ec);
+            return false;
         }
-        size_t reqSize = 0;
-        if (bytes_read != 0) {
-            reqSize = *reinterpret_cast<size_t*>(mBuffer.get());
+        // The arguments are deserialized before execute returns, the frame is only valid until then
+        mFrame = frame;
+        Command cmd;
+        memcpy(&cmd, frame + HEADER_SIZE, sizeof(cmd));
+        this->execute_impl(cmd);
+        mFrame = nullptr;
+        if (doQuit) {
+            // Stop only after the responses queued so far (including the one to this request) were sent
+            auto& service = impl::getIoService(mSocket);
+            mWriteQueue.onFlushed([&service] () {
+                service.stop();
+            });
+            return false;
         }
-        if (bytes_read != 0 && reqSize == bytes_read) {
-            // done reading
-            auto cmd = *reinterpret_cast<Command*>(mBuffer.get() + sizeof(size_t));
-            this->execute_impl(cmd);
+        return !mClosed;
+    }
+
+    void close(const error_code& ec) {
+        if (mClosed) {
             return;
-        } else if (bytes_read >= 8 && reqSize > mBufSize) {
-            std::unique_ptr<uint8_t[]> newBuf(new uint8_t[reqSize]);
-            memcpy(newBuf.get(), mBuffer.get(), mBufSize);
-            mBuffer.swap(newBuf);
-            mBufSize = reqSize;
         }
-        mSocket.async_read_some(boost::asio::buffer(mBuffer.get() + bytes_read, mBufSize - bytes_read),
-                [this, bytes_read](const error_code& ec, size_t br){
-                    if (ec) {
-                        std::cerr << ec.message() << std::endl;
-                        mSocket.close();
-                        mImpl.close();
-                        return;
-                    }
-                    read(bytes_read + br);
-                });
+        mClosed = true;
+        if (ec != boost::asio::error::eof) {
+            std::cerr << ec.message() << std::endl;
+        }
+        mSocket.close();
+        mImpl.close();
+        if (mOnClose) {
+            mOnClose();
+        }
+    }
+
+    void write(BufferPool::Buffer response, size_t size) {
+        if (mClosed) {
+            return;
+        }
+        mWriteQueue.write(std::move(response), size);
     }
 };
 
 } // namespace protocol
 } // namespace crossbow
-
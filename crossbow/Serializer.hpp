@@ -28,3 +28,5 @@
 #include <crossbow/serializer/vector.hpp>
 #include <crossbow/serializer/map.hpp>
 #include <crossbow/serializer/unordered_map.hpp>
+#include <crossbow/serializer/concurrent_map.hpp>
+#include <crossbow/serializer/BufferSerializer.hpp>
@@ -28,8 +28,69 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
 
 namespace crossbow {
+namespace impl {
+
+template <size_t Size>
+struct uint_of_size;
+
+template <>
+struct uint_of_size<1> {
+    using type = uint8_t;
+};
+
+template <>
+struct uint_of_size<2> {
+    using type = uint16_t;
+};
+
+template <>
+struct uint_of_size<4> {
+    using type = uint32_t;
+};
+
+template <>
+struct uint_of_size<8> {
+    using type = uint64_t;
+};
+
+inline uint8_t byte_swap_bits(uint8_t value) {
+    return value;
+}
+
+inline uint16_t byte_swap_bits(uint16_t value) {
+    return __builtin_bswap16(value);
+}
+
+inline uint32_t byte_swap_bits(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+inline uint64_t byte_swap_bits(uint64_t value) {
+    return __builtin_bswap64(value);
+}
+
+/**
+ * @brief Reverses the byte order of the value if the host byte order is not the requested one
+ *
+ * Works for all 1, 2, 4 and 8 byte trivially copyable types (integers, enums and floating point numbers).
+ */
+template <bool LittleEndian, typename T>
+T convert_endian(T value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be converted");
+    if (LittleEndian == (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) {
+        return value;
+    }
+    typename uint_of_size<sizeof(T)>::type bits;
+    memcpy(&bits, &value, sizeof(T));
+    bits = byte_swap_bits(bits);
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+} // namespace impl
 
 /**
  * @brief The buffer_reader class used to read values from a buffer
@@ -74,18 +135,82 @@ public:
         return (mPos >= mEnd);
     }
 
+    /**
+     * @brief Number of bytes left in the buffer
+     */
+    size_t remaining() const {
+        return (mPos < mEnd ? static_cast<size_t>(mEnd - mPos) : 0u);
+    }
+
     bool canRead(size_t length) const {
-        return (mPos + length <= mEnd);
+        return (length <= remaining());
     }
 
+    /**
+     * @brief Reads a value in host byte order
+     *
+     * The value may be unaligned, the memcpy compiles to a single load. The caller has to check that enough bytes are
+     * available.
+     */
     template <typename T>
     T read() {
-        auto value = (*reinterpret_cast<const T*>(mPos));
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read");
+        assert(canRead(sizeof(T)));
+        T value;
+        memcpy(&value, mPos, sizeof(T));
         mPos += sizeof(T);
         return value;
     }
 
+    /**
+     * @brief Reads a value in host byte order if enough bytes are available
+     *
+     * @return False (without advancing) if the buffer holds less than sizeof(T) bytes
+     */
+    template <typename T>
+    bool tryRead(T& value) {
+        if (!canRead(sizeof(T))) {
+            return false;
+        }
+        value = read<T>();
+        return true;
+    }
+
+    template <typename T>
+    T readLittleEndian() {
+        return impl::convert_endian<true>(read<T>());
+    }
+
+    template <typename T>
+    T readBigEndian() {
+        return impl::convert_endian<false>(read<T>());
+    }
+
+    /**
+     * @brief Copies count values in host byte order into dest
+     */
+    template <typename T>
+    void readArray(T* dest, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read");
+        assert(count <= remaining() / sizeof(T));
+        memcpy(dest, mPos, count * sizeof(T));
+        mPos += count * sizeof(T);
+    }
+
+    /**
+     * @return False (without advancing) if the buffer holds less than count values
+     */
+    template <typename T>
+    bool tryReadArray(T* dest, size_t count) {
+        if (count > remaining() / sizeof(T)) {
+            return false;
+        }
+        readArray(dest, count);
+        return true;
+    }
+
     const char* read(size_t length) {
+        assert(canRead(length));
         auto value = mPos;
         mPos += length;
         return value;
@@ -100,6 +225,7 @@ public:
     }
 
     void advance(size_t length) {
+        assert(canRead(length));
         mPos += length;
     }
 
@@ -108,6 +234,7 @@ public:
     }
 
     buffer_reader extract(size_t length) {
+        assert(canRead(length));
         auto value = buffer_reader(mPos, length);
         mPos += length;
         return value;
@@ -165,22 +292,84 @@ public:
         return (mPos >= mEnd);
     }
 
+    /**
+     * @brief Number of bytes left in the buffer
+     */
+    size_t remaining() const {
+        return (mPos < mEnd ? static_cast<size_t>(mEnd - mPos) : 0u);
+    }
+
     bool canWrite(size_t length) const {
-        return (mPos + length <= mEnd);
+        return (length <= remaining());
     }
 
+    /**
+     * @brief Writes a value in host byte order
+     *
+     * The target may be unaligned, the memcpy compiles to a single store. The caller has to check that enough space is
+     * available.
+     */
     template <typename T>
     void write(T value) {
-        (*reinterpret_cast<T*>(mPos)) = value;
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+        assert(canWrite(sizeof(T)));
+        memcpy(mPos, &value, sizeof(T));
         mPos += sizeof(T);
     }
 
+    /**
+     * @return False (without advancing) if the buffer has less than sizeof(T) bytes left
+     */
+    template <typename T>
+    bool tryWrite(T value) {
+        if (!canWrite(sizeof(T))) {
+            return false;
+        }
+        write<T>(value);
+        return true;
+    }
+
+    template <typename T>
+    void writeLittleEndian(T value) {
+        write<T>(impl::convert_endian<true>(value));
+    }
+
+    template <typename T>
+    void writeBigEndian(T value) {
+        write<T>(impl::convert_endian<false>(value));
+    }
+
+    /**
+     * @brief Copies count values in host byte order from src into the buffer
+     */
+    template <typename T>
+    void writeArray(const T* src, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+        assert(count <= remaining() / sizeof(T));
+        memcpy(mPos, src, count * sizeof(T));
+        mPos += count * sizeof(T);
+    }
+
+    /**
+     * @return False (without advancing) if the buffer has no space for count values
+     */
+    template <typename T>
+    bool tryWriteArray(const T* src, size_t count) {
+        if (count > remaining() / sizeof(T)) {
+            return false;
+        }
+        writeArray(src, count);
+        return true;
+    }
+
     void write(const void* value, size_t length) {
+        assert(canWrite(length));
         memcpy(mPos, value, length);
         mPos += length;
     }
 
     void set(int value, size_t length) {
+        assert(canWrite(length));
         memset(mPos, value, length);
         mPos += length;
     }
@@ -194,6 +383,7 @@ public:
     }
 
     void advance(size_t length) {
+        assert(canWrite(length));
         mPos += length;
     }
 
@@ -202,6 +392,7 @@ public:
     }
 
     buffer_writer extract(size_t length) {
+        assert(canWrite(length));
         auto value = buffer_writer(mPos, length);
         mPos += length;
         return value;
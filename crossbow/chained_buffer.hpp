@@ -0,0 +1,404 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/byte_buffer.hpp>
+#include <crossbow/non_copyable.hpp>
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace crossbow {
+
+/**
+ * @brief Pool of fixed size segments used by chained_buffer
+ *
+ * The pool either allocates segments on demand or carves them out of a caller provided memory area (e.g. a region
+ * registered with the network card). Released segments are handed out again, so a steady state workload does not
+ * allocate. The pool is not thread safe and must outlive all buffers using it.
+ */
+class chained_buffer_pool : crossbow::non_copyable, crossbow::non_movable {
+public:
+    /**
+     * @brief Pool allocating segments of the given size on demand
+     */
+    explicit chained_buffer_pool(size_t segmentSize = 4096)
+            : mSegmentSize(segmentSize),
+              mGrowable(true) {
+        assert(segmentSize != 0);
+    }
+
+    /**
+     * @brief Pool using only the segments fitting into the given memory area
+     *
+     * The memory is not owned by the pool.
+     */
+    chained_buffer_pool(char* memory, size_t length, size_t segmentSize)
+            : mSegmentSize(segmentSize),
+              mGrowable(false) {
+        assert(segmentSize != 0);
+        for (auto count = length / segmentSize; count != 0; --count) {
+            mFree.push_back(memory + (count - 1) * segmentSize);
+        }
+    }
+
+    size_t segmentSize() const {
+        return mSegmentSize;
+    }
+
+    /**
+     * @brief Acquires a segment of segmentSize() bytes
+     *
+     * @return The segment or nullptr if the pool is backed by a memory area and all segments are in use
+     */
+    char* acquire() {
+        if (!mFree.empty()) {
+            auto segment = mFree.back();
+            mFree.pop_back();
+            return segment;
+        }
+        if (!mGrowable) {
+            return nullptr;
+        }
+        mOwned.emplace_back(new char[mSegmentSize]);
+        return mOwned.back().get();
+    }
+
+    /**
+     * @brief Returns a segment acquired from this pool
+     */
+    void release(char* segment) {
+        mFree.push_back(segment);
+    }
+
+private:
+    size_t mSegmentSize;
+    bool mGrowable;
+    std::vector<char*> mFree;
+    std::vector<std::unique_ptr<char[]>> mOwned;
+};
+
+/**
+ * @brief Growable byte buffer consisting of a chain of fixed size segments
+ *
+ * Messages can be assembled without knowing their length in advance: The buffer appends a new segment from the pool
+ * whenever the current one is full. Fields whose value is only known later (e.g. a length prefix) are reserved and
+ * filled in afterwards.
+ *
+ * Values written with write<T>() and space obtained through reserve() or extract() are always contiguous, they are
+ * moved to the next segment if they do not fit into the remaining space of the current one. The unused tail is not part
+ * of the data. Only raw byte arrays written with write(const void*, size_t) are split across segments.
+ *
+ * The data is exposed as a list of segments (e.g. for vectored or scatter gather sends) and only copied into a single
+ * contiguous buffer on request.
+ */
+class chained_buffer : crossbow::non_copyable {
+public:
+    struct segment {
+        const char* data;
+        size_t length;
+    };
+
+    /**
+     * @brief Placeholder for a value written after the data following it
+     *
+     * Stays valid until the buffer is reset or destroyed.
+     */
+    template <typename T>
+    class reservation {
+    public:
+        reservation()
+                : mPos(nullptr) {
+        }
+
+        void set(T value) {
+            assert(mPos != nullptr);
+            memcpy(mPos, &value, sizeof(T));
+        }
+
+        void setLittleEndian(T value) {
+            set(impl::convert_endian<true>(value));
+        }
+
+        void setBigEndian(T value) {
+            set(impl::convert_endian<false>(value));
+        }
+
+    private:
+        friend class chained_buffer;
+
+        explicit reservation(char* pos)
+                : mPos(pos) {
+        }
+
+        char* mPos;
+    };
+
+    explicit chained_buffer(chained_buffer_pool& pool)
+            : mPool(&pool),
+              mPos(nullptr),
+              mEnd(nullptr),
+              mSize(0) {
+    }
+
+    chained_buffer(chained_buffer&& other)
+            : mPool(other.mPool),
+              mSegments(std::move(other.mSegments)),
+              mPos(other.mPos),
+              mEnd(other.mEnd),
+              mSize(other.mSize) {
+        other.mSegments.clear();
+        other.mPos = nullptr;
+        other.mEnd = nullptr;
+        other.mSize = 0;
+    }
+
+    chained_buffer& operator=(chained_buffer&& other) {
+        if (this != &other) {
+            releaseAll();
+            mPool = other.mPool;
+            mSegments = std::move(other.mSegments);
+            mPos = other.mPos;
+            mEnd = other.mEnd;
+            mSize = other.mSize;
+            other.mSegments.clear();
+            other.mPos = nullptr;
+            other.mEnd = nullptr;
+            other.mSize = 0;
+        }
+        return *this;
+    }
+
+    ~chained_buffer() {
+        releaseAll();
+    }
+
+    /**
+     * @brief Total number of bytes written
+     */
+    size_t size() const {
+        return mSize;
+    }
+
+    bool empty() const {
+        return (mSize == 0);
+    }
+
+    /**
+     * @brief Number of segments holding data
+     */
+    size_t segmentCount() const {
+        return mSegments.size();
+    }
+
+    /**
+     * @brief The data in the segment with the given index
+     */
+    segment at(size_t index) const {
+        assert(index < mSegments.size());
+        auto& s = mSegments[index];
+        auto length = (index + 1 == mSegments.size() ? static_cast<size_t>(mPos - s.data) : s.length);
+        return segment{s.data, length};
+    }
+
+    /**
+     * @brief Invokes fun(const char* data, size_t length) for every segment in order
+     */
+    template <typename Fun>
+    void forEachSegment(Fun fun) const {
+        for (size_t i = 0; i < mSegments.size(); ++i) {
+            auto s = at(i);
+            fun(s.data, s.length);
+        }
+    }
+
+    /**
+     * @brief Appends an iovec for every non empty segment (e.g. to be used with writev or sendmsg)
+     */
+    void appendTo(std::vector<struct iovec>& iov) const {
+        forEachSegment([&iov] (const char* data, size_t length) {
+            if (length != 0) {
+                iov.push_back(iovec{const_cast<char*>(data), length});
+            }
+        });
+    }
+
+    template <typename T>
+    void write(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+        auto pos = allocate(sizeof(T));
+        memcpy(pos, &value, sizeof(T));
+    }
+
+    template <typename T>
+    void writeLittleEndian(T value) {
+        write<T>(impl::convert_endian<true>(value));
+    }
+
+    template <typename T>
+    void writeBigEndian(T value) {
+        write<T>(impl::convert_endian<false>(value));
+    }
+
+    /**
+     * @brief Appends the bytes, filling up the current segment before acquiring new ones
+     */
+    void write(const void* value, size_t length) {
+        auto src = reinterpret_cast<const char*>(value);
+        while (length != 0) {
+            if (mPos == mEnd) {
+                nextSegment();
+            }
+            auto count = std::min(length, static_cast<size_t>(mEnd - mPos));
+            memcpy(mPos, src, count);
+            mPos += count;
+            mSize += count;
+            src += count;
+            length -= count;
+        }
+    }
+
+    /**
+     * @brief Reserves space for a value to be set later
+     */
+    template <typename T>
+    reservation<T> reserve() {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+        return reservation<T>(allocate(sizeof(T)));
+    }
+
+    /**
+     * @brief Reserves contiguous space of the given length and returns a writer for it
+     *
+     * The length may not exceed the segment size. All bytes of the returned writer are part of the data.
+     */
+    buffer_writer extract(size_t length) {
+        return buffer_writer(allocate(length), length);
+    }
+
+    /**
+     * @brief Copies the data into dest which must hold at least size() bytes
+     */
+    void copyTo(char* dest) const {
+        forEachSegment([&dest] (const char* data, size_t length) {
+            memcpy(dest, data, length);
+            dest += length;
+        });
+    }
+
+    /**
+     * @brief Copies the data into the writer
+     *
+     * @exception std::length_error In case the writer has not enough space left
+     */
+    void copyTo(buffer_writer& writer) const {
+        if (!writer.canWrite(mSize)) {
+            throw std::length_error("Buffer too small for chained buffer");
+        }
+        copyTo(writer.data());
+        writer.advance(mSize);
+    }
+
+    /**
+     * @brief Copies the data into a single contiguous buffer
+     */
+    std::vector<char> flatten() const {
+        std::vector<char> result(mSize);
+        copyTo(result.data());
+        return result;
+    }
+
+    /**
+     * @brief Clears the data
+     *
+     * The first segment is kept for reuse, all other segments are returned to the pool.
+     */
+    void reset() {
+        if (mSegments.empty()) {
+            return;
+        }
+        for (size_t i = 1; i < mSegments.size(); ++i) {
+            mPool->release(mSegments[i].data);
+        }
+        mSegments.resize(1);
+        mPos = mSegments.front().data;
+        mEnd = mPos + mPool->segmentSize();
+        mSize = 0;
+    }
+
+private:
+    struct chain_entry {
+        char* data;
+        size_t length;
+    };
+
+    char* allocate(size_t length) {
+        if (static_cast<size_t>(mEnd - mPos) < length) {
+            if (length > mPool->segmentSize()) {
+                throw std::length_error("Value larger than the segment size");
+            }
+            nextSegment();
+        }
+        auto pos = mPos;
+        mPos += length;
+        mSize += length;
+        return pos;
+    }
+
+    void nextSegment() {
+        auto data = mPool->acquire();
+        if (data == nullptr) {
+            throw std::length_error("No segment available in the pool");
+        }
+        if (!mSegments.empty()) {
+            mSegments.back().length = static_cast<size_t>(mPos - mSegments.back().data);
+        }
+        mSegments.push_back(chain_entry{data, 0});
+        mPos = data;
+        mEnd = data + mPool->segmentSize();
+    }
+
+    void releaseAll() {
+        for (auto& s : mSegments) {
+            mPool->release(s.data);
+        }
+        mSegments.clear();
+    }
+
+    chained_buffer_pool* mPool;
+    std::vector<chain_entry> mSegments;
+    char* mPos;
+    char* mEnd;
+    size_t mSize;
+};
+
+} // namespace crossbow
@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace crossbow {
+namespace impl {
+
+/**
+ * @brief Constants mixed into the hash
+ *
+ * A static member of a class template so all translation units share a single definition.
+ */
+template<class Dummy = void>
+struct hash_secret {
+    static constexpr uint64_t value[4] = {
+        0xa0761d6478bd642full,
+        0xe7037ed1a0b428dbull,
+        0x8ebc6af09c88c6e3ull,
+        0x589965cc75374cc3ull
+    };
+};
+
+template<class Dummy>
+constexpr uint64_t hash_secret<Dummy>::value[4];
+
+/**
+ * @brief Multiplies both values to 128 bit and stores the lower and upper half in a and b
+ */
+inline void hash_multiply(uint64_t& a, uint64_t& b) {
+#ifdef __SIZEOF_INT128__
+    auto r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    auto ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    auto rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    auto t = rl + (rm0 << 32);
+    auto c = static_cast<uint64_t>(t < rl);
+    auto lo = t + (rm1 << 32);
+    c += (lo < t);
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_multiply(a, b);
+    return a ^ b;
+}
+
+inline uint64_t hash_read8(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t hash_read4(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Reads 1 to 3 bytes
+ */
+inline uint64_t hash_read3(const unsigned char* p, size_t length) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+}
+
+} // namespace impl
+
+/**
+ * @brief Hashes a sequence of bytes
+ *
+ * Word at a time hash in the style of wyhash: Inputs of up to 16 bytes are hashed without a loop, longer inputs are
+ * processed in blocks of 16 bytes (or in three independent lanes for inputs longer than 48 bytes) with 128 bit
+ * multiplications. The result is not stable across platforms with different byte order.
+ */
+inline uint64_t hash_bytes(const void* key, size_t length, uint64_t seed = 0) {
+    using namespace impl;
+    const auto& secret = hash_secret<>::value;
+    auto p = static_cast<const unsigned char*>(key);
+    seed ^= hash_mix(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            auto offset = (length >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + offset);
+            b = (hash_read4(p + length - 4) << 32) | hash_read4(p + length - 4 - offset);
+        } else if (length > 0) {
+            a = hash_read3(p, length);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        auto i = length;
+        if (i > 48) {
+            auto seed1 = seed, seed2 = seed;
+            do {
+                seed = hash_mix(hash_read8(p) ^ secret[1], hash_read8(p + 8) ^ seed);
+                seed1 = hash_mix(hash_read8(p + 16) ^ secret[2], hash_read8(p + 24) ^ seed1);
+                seed2 = hash_mix(hash_read8(p + 32) ^ secret[3], hash_read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_read8(p) ^ secret[1], hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    hash_multiply(a, b);
+    return hash_mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+} // namespace crossbow
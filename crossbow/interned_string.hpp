@@ -0,0 +1,284 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/hash.hpp>
+#include <crossbow/singleton.hpp>
+#include <crossbow/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace crossbow {
+namespace impl {
+
+/**
+ * @brief Immutable string stored in the intern table
+ *
+ * The characters (followed by a null terminator) are stored directly after the entry. Entries are never freed.
+ */
+struct interned_entry {
+    interned_entry* next;
+    size_t hash;
+    size_t size;
+
+    const char* data() const {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+};
+
+/**
+ * @brief Concurrent table holding one entry per distinct string
+ *
+ * The table is split into shards selected by the upper bits of the hash, each shard is a chained hash table protected
+ * by its own mutex.
+ */
+class intern_table {
+public:
+    static constexpr size_t SHARD_BITS = 6;
+    static constexpr size_t INITIAL_BUCKETS = 64;
+
+    intern_table() = default;
+    intern_table(const intern_table&) = delete;
+    intern_table& operator=(const intern_table&) = delete;
+
+    /**
+     * @brief Returns the entry for the given string, inserting it if it does not exist yet
+     */
+    const interned_entry* intern(const char* str, size_t size) {
+        return intern(str, size, static_cast<size_t>(hash_bytes(str, size)));
+    }
+
+    const interned_entry* intern(const char* str, size_t size, size_t hash) {
+        auto& shard = mShards[hash >> (sizeof(size_t) * 8 - SHARD_BITS)];
+        std::lock_guard<std::mutex> _(shard.mutex);
+        if (shard.buckets.empty()) {
+            shard.buckets.resize(INITIAL_BUCKETS, nullptr);
+        }
+        auto& head = shard.buckets[hash & (shard.buckets.size() - 1)];
+        for (auto entry = head; entry != nullptr; entry = entry->next) {
+            if (entry->hash == hash && entry->size == size && std::memcmp(entry->data(), str, size) == 0) {
+                return entry;
+            }
+        }
+
+        auto memory = ::operator new(sizeof(interned_entry) + size + 1);
+        auto entry = new (memory) interned_entry{head, hash, size};
+        auto data = const_cast<char*>(entry->data());
+        std::memcpy(data, str, size);
+        data[size] = '\0';
+        head = entry;
+        if (++shard.size > shard.buckets.size()) {
+            shard.grow();
+        }
+        return entry;
+    }
+
+    /**
+     * @brief Number of distinct strings in the table
+     */
+    size_t size() {
+        size_t res = 0;
+        for (auto& shard : mShards) {
+            std::lock_guard<std::mutex> _(shard.mutex);
+            res += shard.size;
+        }
+        return res;
+    }
+
+    /**
+     * @brief The entry shared by all empty strings, it is not part of the table
+     */
+    static const interned_entry* empty() {
+        static const struct {
+            interned_entry entry;
+            char terminator;
+        } gEmpty = {{nullptr, static_cast<size_t>(hash_bytes("", 0)), 0}, '\0'};
+        return &gEmpty.entry;
+    }
+
+private:
+    struct shard_type {
+        std::mutex mutex;
+        std::vector<interned_entry*> buckets;
+        size_t size = 0;
+
+        void grow() {
+            std::vector<interned_entry*> res(buckets.size() * 2, nullptr);
+            for (auto entry : buckets) {
+                while (entry != nullptr) {
+                    auto next = entry->next;
+                    auto& head = res[entry->hash & (res.size() - 1)];
+                    entry->next = head;
+                    head = entry;
+                    entry = next;
+                }
+            }
+            buckets.swap(res);
+        }
+    };
+
+    std::array<shard_type, size_t(1) << SHARD_BITS> mShards;
+};
+
+using intern_table_holder = singleton<intern_table, create_static<intern_table>, infinite_lifetime<intern_table>>;
+
+} // namespace impl
+
+/**
+ * @brief Immutable string whose characters are stored once in a process wide intern table
+ *
+ * Constructing an interned_string hashes the string and looks it up in the intern table, after that copies,
+ * comparisons and hashing only touch a pointer. Two interned strings are equal if and only if they point to the same
+ * entry. Interned strings are never freed, so the type should only be used for a bounded set of identifiers (table
+ * names, column names, endpoints).
+ */
+class interned_string {
+public:
+    using value_type = char;
+    using size_type = size_t;
+    using const_iterator = const char*;
+
+    interned_string()
+            : entry_(impl::intern_table::empty()) {
+    }
+
+    interned_string(const char* str, size_t size)
+            : entry_(size == 0 ? impl::intern_table::empty() : impl::intern_table_holder::instance().intern(str, size)) {
+    }
+
+    explicit interned_string(const char* str)
+            : interned_string(str, std::strlen(str)) {
+    }
+
+    template<class Traits, class Allocator>
+    explicit interned_string(const basic_string<char, Traits, Allocator>& str)
+            : interned_string(str.data(), str.size()) {
+    }
+
+    template<class Traits, class Allocator>
+    explicit interned_string(const std::basic_string<char, Traits, Allocator>& str)
+            : interned_string(str.data(), str.size()) {
+    }
+
+    const char* data() const {
+        return entry_->data();
+    }
+
+    const char* c_str() const {
+        return entry_->data();
+    }
+
+    size_type size() const {
+        return entry_->size;
+    }
+
+    size_type length() const {
+        return entry_->size;
+    }
+
+    bool empty() const {
+        return entry_->size == 0;
+    }
+
+    const_iterator begin() const {
+        return data();
+    }
+
+    const_iterator end() const {
+        return data() + size();
+    }
+
+    char operator[](size_type pos) const {
+        return data()[pos];
+    }
+
+    /**
+     * @brief The precomputed hash, equal to hash_value() of a crossbow::string with the same content
+     */
+    size_t hash() const {
+        return entry_->hash;
+    }
+
+    string str() const {
+        return string(data(), size());
+    }
+
+    /**
+     * @brief Compares the content of both strings lexicographically
+     */
+    int compare(const interned_string& other) const {
+        if (entry_ == other.entry_) {
+            return 0;
+        }
+        auto res = std::memcmp(data(), other.data(), std::min(size(), other.size()));
+        if (res != 0) {
+            return res;
+        }
+        return size() < other.size() ? -1 : (size() == other.size() ? 0 : 1);
+    }
+
+    friend bool operator==(const interned_string& lhs, const interned_string& rhs) {
+        return lhs.entry_ == rhs.entry_;
+    }
+
+    friend bool operator!=(const interned_string& lhs, const interned_string& rhs) {
+        return lhs.entry_ != rhs.entry_;
+    }
+
+    friend bool operator<(const interned_string& lhs, const interned_string& rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+private:
+    const impl::interned_entry* entry_;
+};
+
+inline size_t hash_value(const interned_string& str) {
+    return str.hash();
+}
+
+template<class Traits>
+std::basic_ostream<char, Traits>& operator<<(std::basic_ostream<char, Traits>& out, const interned_string& str) {
+    return out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+} // namespace crossbow
+
+namespace std {
+
+template<>
+struct hash<crossbow::interned_string> {
+    size_t operator()(const crossbow::interned_string& str) const {
+        return str.hash();
+    }
+};
+
+} // namespace std
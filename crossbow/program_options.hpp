@@ -22,10 +22,18 @@
  */
 #pragma once
 #include "program_options/exceptions.hpp"
+#include "program_options/live_options.hpp"
 #include "program_options/parser.hpp"
 #include "program_options/type_printer.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <crossbow/string.hpp>
@@ -290,6 +298,29 @@ struct options<First, Rest...> : options<Rest...> {
         }
     }
 
+    bool set_long(const char* key, const char* value) {
+        if (First::ignore_long || key != this_option.longoption) {
+            return base::set_long(key, value);
+        }
+        parser<value_type> p;
+        this_option.set_value(p(value));
+        return true;
+    }
+
+    void parse_env(const std::string &prefix) {
+        if (!First::ignore_long) {
+            std::string var = prefix;
+            for (auto c : this_option.longoption) {
+                var.push_back(c == '-' ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+            }
+            if (auto value = std::getenv(var.c_str())) {
+                parser<value_type> p;
+                this_option.set_value(p(value));
+            }
+        }
+        base::parse_env(prefix);
+    }
+
     bool parse_short(char n, int &i, const char** argv) {
         if (name == n && !First::ignore_short) {
             return parse_impl<value_type>(i, argv);
@@ -323,6 +354,13 @@ struct options<> {
         throw argument_not_found(err.c_str());
     }
 
+    bool set_long(const char*, const char*) {
+        return false;
+    }
+
+    void parse_env(const std::string &) {
+    }
+
     constexpr static bool is_unique(char) {
         return true;
     }
@@ -360,6 +398,12 @@ decltype(std::declval<O>().template get<Name>()) get(const std::unique_ptr<O> &o
     return o.template get<Name>();
 }
 
+template<char Name, class O>
+decltype(std::declval<O>().template get<Name>()) get(const std::shared_ptr<const O> &opts) {
+    const O &o = *opts;
+    return o.template get<Name>();
+}
+
 template<class... Opts>
 std::unique_ptr<impl::options<Opts...>> create_options(const string &name, Opts && ... opts) {
     using res_type = impl::options<Opts...>;
@@ -406,5 +450,72 @@ int parse(O &opts, int argc, const char** argv) {
     return i;
 }
 
+/**
+ * @brief Sets the option with the given long name from a string value
+ *
+ * Boolean options accept true/false, yes/no, on/off and 1/0.
+ */
+template<class O>
+void set(O &opts, const char* key, const char* value) {
+    if (!opts->set_long(key, value)) {
+        throw argument_not_found(key);
+    }
+}
+
+/**
+ * @brief Parses options from a config stream
+ *
+ * Every line has the form "long-name = value". Empty lines and lines starting with '#' are ignored, whitespace around
+ * names and values is stripped.
+ */
+template<class O>
+void parse_stream(O &opts, std::istream &in) {
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        auto isSpace = [](char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        };
+        auto begin = std::find_if_not(line.begin(), line.end(), isSpace);
+        if (begin == line.end() || *begin == '#') {
+            continue;
+        }
+        auto sep = std::find(begin, line.end(), '=');
+        if (sep == line.end()) {
+            throw parse_error("Missing '=' in line " + std::to_string(lineNumber));
+        }
+        auto keyEnd = std::find_if_not(std::reverse_iterator<std::string::iterator>(sep),
+                std::reverse_iterator<std::string::iterator>(begin), isSpace).base();
+        auto valueBegin = std::find_if_not(sep + 1, line.end(), isSpace);
+        auto valueEnd = std::find_if_not(line.rbegin(), std::reverse_iterator<std::string::iterator>(valueBegin),
+                isSpace).base();
+        std::string key(begin, keyEnd);
+        std::string value(valueBegin, valueEnd);
+        set(opts, key.c_str(), value.c_str());
+    }
+}
+
+/**
+ * @brief Parses options from a config file (see parse_stream)
+ */
+template<class O>
+void parse_file(O &opts, const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw parse_error("Could not open config file " + path);
+    }
+    parse_stream(opts, in);
+}
+
+/**
+ * @brief Sets all options with a long name found in the environment
+ *
+ * The variable name is the prefix followed by the upper case long name with '-' replaced by '_' (e.g. the option
+ * "poll-cycles" is read from PREFIX_POLL_CYCLES with prefix "PREFIX_").
+ */
+template<class O>
+void parse_env(O &opts, const std::string &prefix) {
+    opts->parse_env(prefix);
+}
+
 }// namespace program_options
 } // namespace crossbow
@@ -0,0 +1,141 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace crossbow {
+
+namespace program_options {
+
+/**
+ * @brief Publishes immutable snapshots of an options object to running threads
+ *
+ * A reload copies the current snapshot, applies the update function to the copy (e.g. parse_file or parse_env) and
+ * publishes the result atomically. If the update function throws (e.g. because of an invalid config file) the current
+ * snapshot stays in place. Reloads are serialized, readers never block on them.
+ *
+ * Options bound to a variable also write that variable on every reload, running threads should read the values through
+ * a snapshot instead.
+ */
+template<class O>
+class live_options {
+public:
+    using options_type = O;
+    using snapshot_type = std::shared_ptr<const O>;
+
+    /**
+     * @brief Caches the snapshot of one thread and only reloads it when a new one was published
+     *
+     * Checking for a new snapshot is a single atomic load.
+     */
+    class view {
+    public:
+        explicit view(const live_options &live)
+            : mLive(&live)
+            , mVersion(live.version())
+            , mCurrent(live.snapshot())
+        {}
+
+        const O &get() {
+            auto version = mLive->version();
+            if (version != mVersion) {
+                mVersion = version;
+                mCurrent = mLive->snapshot();
+            }
+            return *mCurrent;
+        }
+
+        const O* operator->() {
+            return &get();
+        }
+
+    private:
+        const live_options* mLive;
+        uint64_t mVersion;
+        snapshot_type mCurrent;
+    };
+
+    explicit live_options(std::unique_ptr<O> opts)
+        : mCurrent(std::move(opts))
+        , mVersion(0)
+    {}
+
+    snapshot_type snapshot() const {
+        return std::atomic_load_explicit(&mCurrent, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Number of reloads published so far
+     */
+    uint64_t version() const {
+        return mVersion.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Registers a hook invoked with every newly published snapshot
+     *
+     * Hooks are invoked on the reloading thread.
+     */
+    void on_reload(std::function<void(const snapshot_type &)> hook) {
+        std::lock_guard<std::mutex> _(mMutex);
+        mHooks.emplace_back(std::move(hook));
+    }
+
+    /**
+     * @brief Applies fun(std::unique_ptr<O>&) to a copy of the current options and publishes the result
+     */
+    template<class Fun>
+    snapshot_type reload(Fun fun) {
+        std::lock_guard<std::mutex> _(mMutex);
+        std::unique_ptr<O> next(new O(*std::atomic_load_explicit(&mCurrent, std::memory_order_relaxed)));
+        fun(next);
+        snapshot_type published(std::move(next));
+        std::atomic_store_explicit(&mCurrent, published, std::memory_order_release);
+        mVersion.fetch_add(1, std::memory_order_release);
+        for (auto &hook : mHooks) {
+            hook(published);
+        }
+        return published;
+    }
+
+private:
+    std::mutex mMutex;
+    snapshot_type mCurrent;
+    std::atomic<uint64_t> mVersion;
+    std::vector<std::function<void(const snapshot_type &)>> mHooks;
+};
+
+template<class O>
+std::unique_ptr<live_options<O>> make_live(std::unique_ptr<O> opts) {
+    return std::unique_ptr<live_options<O>>(new live_options<O>(std::move(opts)));
+}
+
+} // namespace program_options
+
+} // namespace crossbow
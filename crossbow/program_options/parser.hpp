@@ -21,15 +21,72 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #pragma once
+#include "exceptions.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <strings.h>
 #include <crossbow/string.hpp>
 
 namespace crossbow {
 
 namespace program_options {
 
+namespace impl {
+
+[[noreturn]] inline void throw_invalid(const char* str, const char* type) {
+    throw parse_error(std::string(str) + " is not a valid " + type);
+}
+
+inline bool only_space(const char* str) {
+    while (std::isspace(static_cast<unsigned char>(*str))) ++str;
+    return *str == '\0';
+}
+
+/**
+ * Numbers are parsed in place with the strto* functions (decimal, octal with a leading 0 or hexadecimal with a
+ * leading 0x). The whole string except for trailing whitespace has to be consumed.
+ */
+template<class T>
+T parse_signed(const char* str, const char* type) {
+    char* end;
+    errno = 0;
+    long long val = std::strtoll(str, &end, 0);
+    if (end == str || errno == ERANGE || !only_space(end)
+            || val < std::numeric_limits<T>::min() || val > std::numeric_limits<T>::max()) {
+        throw_invalid(str, type);
+    }
+    return static_cast<T>(val);
+}
+
+template<class T>
+T parse_unsigned(const char* str, const char* type) {
+    char* end;
+    errno = 0;
+    unsigned long long val = std::strtoull(str, &end, 0);
+    if (end == str || errno == ERANGE || !only_space(end) || val > std::numeric_limits<T>::max()) {
+        throw_invalid(str, type);
+    }
+    return static_cast<T>(val);
+}
+
+template<class T, T (*Fun)(const char*, char**)>
+T parse_floating(const char* str, const char* type) {
+    char* end;
+    errno = 0;
+    T val = Fun(str, &end);
+    if (end == str || errno == ERANGE || !only_space(end)) {
+        throw_invalid(str, type);
+    }
+    return val;
+}
+
+} // namespace impl
+
 template<class T>
 struct parser;
 
@@ -47,6 +104,21 @@ struct parser<string> {
     }
 };
 
+template<>
+struct parser<bool> {
+    bool operator()(const char* str) const {
+        if (strcasecmp(str, "true") == 0 || strcasecmp(str, "yes") == 0 || strcasecmp(str, "on") == 0
+                || strcmp(str, "1") == 0) {
+            return true;
+        }
+        if (strcasecmp(str, "false") == 0 || strcasecmp(str, "no") == 0 || strcasecmp(str, "off") == 0
+                || strcmp(str, "0") == 0) {
+            return false;
+        }
+        impl::throw_invalid(str, "bool");
+    }
+};
+
 template<>
 struct parser<char> {
     char operator()(const char* str) const {
@@ -60,133 +132,77 @@ struct parser<char> {
 template<>
 struct parser<short> {
     short operator()(const char* str) const {
-        try {
-            int val = std::stoi(std::string(str), nullptr, 0);
-            if (val < std::numeric_limits<short>::min() || val > std::numeric_limits<short>::max()) {
-                throw std::out_of_range("Invalid range");
-            }
-            return static_cast<short>(val);
-        } catch (...) {
-            throw parse_error(str + std::string(" is not a valid short"));
-        }
+        return impl::parse_signed<short>(str, "short");
     }
 };
 
 template<>
 struct parser<int> {
     int operator()(const char* str) const {
-        try {
-            return std::stoi(std::string(str), nullptr, 0);
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid int"));
-        }
+        return impl::parse_signed<int>(str, "int");
     }
 };
 
 template<>
 struct parser<long> {
     long operator()(const char* str) const {
-        try {
-            return std::stol(std::string(str), nullptr, 0);
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid long"));
-        }
+        return impl::parse_signed<long>(str, "long");
     }
 };
 
 template<>
 struct parser<long long> {
     long long operator()(const char* str) const {
-        try {
-            return std::stoll(std::string(str), nullptr, 0);
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid long long"));
-        }
+        return impl::parse_signed<long long>(str, "long long");
     }
 };
 
 template<>
 struct parser<unsigned short> {
     unsigned short operator()(const char* str) const {
-        try {
-            unsigned long val = std::stoul(std::string(str), nullptr, 0);
-            if (val > std::numeric_limits<unsigned short>::max()) {
-                throw std::out_of_range("Invalid range");
-            }
-            return static_cast<unsigned short>(val);
-        } catch (...) {
-            throw parse_error(str + std::string(" is not a valid unsigned short"));
-        }
+        return impl::parse_unsigned<unsigned short>(str, "unsigned short");
     }
 };
 
 template<>
 struct parser<unsigned> {
     unsigned operator()(const char* str) const {
-        try {
-            unsigned long val = std::stoul(std::string(str), nullptr, 0);
-            if (val > std::numeric_limits<unsigned>::max()) {
-                throw std::out_of_range("Invalid range");
-            }
-            return static_cast<unsigned>(val);
-        } catch (...) {
-            throw parse_error(str + std::string(" is not a valid unsigned"));
-        }
+        return impl::parse_unsigned<unsigned>(str, "unsigned");
     }
 };
 
 template<>
 struct parser<unsigned long> {
     unsigned long operator()(const char* str) const {
-        try {
-            return std::stoul(std::string(str), nullptr, 0);
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid unsigned long"));
-        }
+        return impl::parse_unsigned<unsigned long>(str, "unsigned long");
     }
 };
 
 template<>
 struct parser<unsigned long long> {
     unsigned long long operator()(const char* str) const {
-        try {
-            return std::stoull(std::string(str), nullptr, 0);
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid unsigned long long"));
-        }
+        return impl::parse_unsigned<unsigned long long>(str, "unsigned long long");
     }
 };
 
 template<>
 struct parser<float> {
     float operator()(const char* str) const {
-        try {
-            return std::stof(std::string(str));
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid float"));
-        }
+        return impl::parse_floating<float, std::strtof>(str, "float");
     }
 };
 
 template<>
 struct parser<double> {
     double operator()(const char* str) const {
-        try {
-            return std::stod(std::string(str));
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid double"));
-        }
+        return impl::parse_floating<double, std::strtod>(str, "double");
     }
 };
 
 template<>
 struct parser<long double> {
     long double operator()(const char* str) const {
-        try {
-            return std::stold(std::string(str));
-        } catch (...) {
-            throw parse_error(str + std::string("is not a valid long double"));
-        }
+        return impl::parse_floating<long double, std::strtold>(str, "long double");
     }
 };
 
@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace crossbow {
+namespace protocol {
+
+/**
+ * @brief Pool of message buffers grouped into power of two size classes
+ *
+ * Released buffers are cached (up to a maximum number per size class) and handed out again for requests of the same
+ * size class, so a steady state workload does not allocate. The pool is not thread safe.
+ */
+class BufferPool {
+public:
+    /// Smallest size class (1 KiB)
+    static constexpr size_t MIN_CLASS = 10;
+
+    /// Number of size classes, the largest one holds buffers of MAX_SIZE bytes
+    static constexpr size_t NUM_CLASSES = sizeof(size_t) * 8 - MIN_CLASS;
+
+    /// Largest buffer size the pool hands out
+    static constexpr size_t MAX_SIZE = size_t(1) << (NUM_CLASSES - 1 + MIN_CLASS);
+
+    static_assert(NUM_CLASSES - 1 + MIN_CLASS < sizeof(size_t) * 8, "Largest size class must be representable");
+
+    struct Buffer {
+        Buffer()
+            : capacity(0)
+        {}
+
+        Buffer(std::unique_ptr<uint8_t[]> d, size_t c)
+            : data(std::move(d))
+            , capacity(c)
+        {}
+
+        std::unique_ptr<uint8_t[]> data;
+        size_t capacity;
+    };
+
+    /**
+     * @param maxCached Maximum number of buffers cached per size class
+     */
+    explicit BufferPool(size_t maxCached = 16)
+        : mMaxCached(maxCached)
+        , mFree(NUM_CLASSES)
+    {}
+
+    /**
+     * @brief Acquires a buffer with a capacity of at least size bytes
+     *
+     * @exception std::length_error In case size is larger than MAX_SIZE
+     */
+    Buffer acquire(size_t size) {
+        if (size > MAX_SIZE) {
+            throw std::length_error("Buffer size exceeds the maximum pool buffer size");
+        }
+        auto c = sizeClass(size);
+        auto& freeList = mFree[c];
+        if (!freeList.empty()) {
+            Buffer buffer(std::move(freeList.back()), size_t(1) << (c + MIN_CLASS));
+            freeList.pop_back();
+            return buffer;
+        }
+        auto capacity = size_t(1) << (c + MIN_CLASS);
+        return Buffer(std::unique_ptr<uint8_t[]>(new uint8_t[capacity]), capacity);
+    }
+
+    /**
+     * @brief Returns a buffer acquired from this pool
+     */
+    void release(Buffer buffer) {
+        if (!buffer.data) {
+            return;
+        }
+        auto& freeList = mFree[sizeClass(buffer.capacity)];
+        if (freeList.size() < mMaxCached) {
+            freeList.emplace_back(std::move(buffer.data));
+        }
+    }
+
+private:
+    static size_t sizeClass(size_t size) {
+        size_t c = 0;
+        while (c + 1 < NUM_CLASSES && (size_t(1) << (c + MIN_CLASS)) < size) {
+            ++c;
+        }
+        return c;
+    }
+
+    size_t mMaxCached;
+    std::vector<std::vector<std::unique_ptr<uint8_t[]>>> mFree;
+};
+
+} // namespace protocol
+} // namespace crossbow
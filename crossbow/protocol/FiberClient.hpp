@@ -0,0 +1,94 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/Protocol.hpp>
+
+#include <boost/asio/spawn.hpp>
+#include <boost/version.hpp>
+
+namespace crossbow {
+namespace protocol {
+namespace impl {
+
+template<class Result>
+struct completion_signature {
+    using type = void(boost::system::error_code, Result);
+};
+
+template<>
+struct completion_signature<void> {
+    using type = void(boost::system::error_code);
+};
+
+} // namespace impl
+
+/**
+ * @brief Synchronous interface to a protocol::Client for coroutines started with boost::asio::spawn
+ *
+ * execute suspends the calling coroutine until the response arrived. Any number of coroutines running on the io_service
+ * of the socket can share the same client, their requests are pipelined over the connection.
+ */
+template<class Command, template <Command> class Signature>
+class FiberClient {
+public:
+    using client_type = Client<Command, Signature>;
+
+    FiberClient(client_type& client)
+        : mClient(client)
+    {}
+
+    client_type& client() {
+        return mClient;
+    }
+
+    /**
+     * @brief Executes the command and waits for the result
+     *
+     * @param yield The context of the calling coroutine (use yield[ec] to receive errors as error code)
+     * @param args The arguments of the command
+     * @return The result of the command
+     *
+     * @exception boost::system::system_error In case the request failed and no error code was passed
+     */
+    template<Command C, class... Args>
+    typename Signature<C>::result execute(boost::asio::yield_context yield, const Args&... args) {
+        using signature = typename impl::completion_signature<typename Signature<C>::result>::type;
+#if BOOST_VERSION >= 106600
+        boost::asio::async_completion<boost::asio::yield_context, signature> init(yield);
+        mClient.template execute<C>(init.completion_handler, args...);
+        return init.result.get();
+#else
+        typename boost::asio::handler_type<boost::asio::yield_context, signature>::type handler(yield);
+        boost::asio::async_result<decltype(handler)> result(handler);
+        mClient.template execute<C>(handler, args...);
+        return result.get();
+#endif
+    }
+
+private:
+    client_type& mClient;
+};
+
+} // namespace protocol
+} // namespace crossbow
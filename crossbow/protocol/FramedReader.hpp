@@ -0,0 +1,200 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/protocol/BufferPool.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace crossbow {
+namespace protocol {
+
+/**
+ * @brief Reads length prefixed frames from a socket
+ *
+ * Every frame starts with its total length as size_t. Data is received into a fixed receive buffer and all complete
+ * frames contained in a single read are dispatched before the socket is read again; partial frames are moved to the
+ * beginning of the buffer. Frames larger than the receive buffer are read into a buffer from the pool that is released
+ * after the frame was dispatched.
+ *
+ * The handler is invoked with every frame (only valid during the invocation) and returns whether reading should
+ * continue. On errors the handler is invoked with the error and a null frame. Frames smaller than the minimum or larger
+ * than the maximum frame size are reported as bad_message errors. The reader is not thread safe.
+ */
+class FramedReader {
+public:
+    using error_code = boost::system::error_code;
+    using handler_type = std::function<bool(const error_code&, const uint8_t*, size_t)>;
+
+    /// Default maximum frame size (64 MiB)
+    static constexpr size_t DEFAULT_MAX_FRAME_SIZE = size_t(64) << 20;
+
+    /**
+     * @param socket The socket to read from
+     * @param pool Pool for frames not fitting into the receive buffer
+     * @param minFrameSize Frames smaller than this are rejected as invalid
+     * @param handler Invoked for every frame
+     * @param bufferSize Size of the receive buffer
+     * @param maxFrameSize Frames larger than this are rejected as invalid (limited to BufferPool::MAX_SIZE)
+     */
+    FramedReader(boost::asio::ip::tcp::socket& socket, BufferPool& pool, size_t minFrameSize, handler_type handler,
+            size_t bufferSize = 64 * 1024, size_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE)
+        : mSocket(socket)
+        , mPool(pool)
+        , mMinFrameSize(minFrameSize < sizeof(size_t) ? sizeof(size_t) : minFrameSize)
+        , mMaxFrameSize(std::max(mMinFrameSize, std::min(maxFrameSize, size_t(BufferPool::MAX_SIZE))))
+        , mHandler(std::move(handler))
+        , mBufferSize(bufferSize < mMinFrameSize ? mMinFrameSize : bufferSize)
+        , mBuffer(new uint8_t[mBufferSize])
+        , mBegin(0)
+        , mEnd(0)
+        , mActive(false)
+    {}
+
+    /**
+     * @brief Whether the reader is currently dispatching or waiting for frames
+     */
+    bool active() const {
+        return mActive;
+    }
+
+    /**
+     * @brief Starts dispatching frames, beginning with the frames already buffered
+     */
+    void start() {
+        if (mActive) {
+            return;
+        }
+        mActive = true;
+        process();
+    }
+
+private:
+    void process() {
+        while (true) {
+            auto available = mEnd - mBegin;
+            if (available < sizeof(size_t)) {
+                break;
+            }
+            size_t frameSize;
+            memcpy(&frameSize, mBuffer.get() + mBegin, sizeof(size_t));
+            if (frameSize < mMinFrameSize || frameSize > mMaxFrameSize) {
+                fail(boost::system::errc::make_error_code(boost::system::errc::bad_message));
+                return;
+            }
+            if (frameSize > mBufferSize) {
+                readLarge(frameSize);
+                return;
+            }
+            if (available < frameSize) {
+                if (mBufferSize - mBegin < frameSize) {
+                    memmove(mBuffer.get(), mBuffer.get() + mBegin, available);
+                    mBegin = 0;
+                    mEnd = available;
+                }
+                break;
+            }
+            auto frame = mBuffer.get() + mBegin;
+            mBegin += frameSize;
+            if (!dispatch(frame, frameSize)) {
+                return;
+            }
+        }
+        if (mBegin == mEnd) {
+            mBegin = 0;
+            mEnd = 0;
+        } else if (mEnd == mBufferSize) {
+            auto available = mEnd - mBegin;
+            memmove(mBuffer.get(), mBuffer.get() + mBegin, available);
+            mBegin = 0;
+            mEnd = available;
+        }
+        mSocket.async_read_some(boost::asio::buffer(mBuffer.get() + mEnd, mBufferSize - mEnd),
+                [this](const error_code& ec, size_t bytesRead) {
+                    if (ec) {
+                        fail(ec);
+                        return;
+                    }
+                    mEnd += bytesRead;
+                    process();
+                });
+    }
+
+    void readLarge(size_t frameSize) {
+        auto available = mEnd - mBegin;
+        mLarge = mPool.acquire(frameSize);
+        memcpy(mLarge.data.get(), mBuffer.get() + mBegin, available);
+        mBegin = 0;
+        mEnd = 0;
+        boost::asio::async_read(mSocket,
+                boost::asio::buffer(mLarge.data.get() + available, frameSize - available),
+                [this, frameSize](const error_code& ec, size_t) {
+                    if (ec) {
+                        mPool.release(std::move(mLarge));
+                        fail(ec);
+                        return;
+                    }
+                    auto buffer = std::move(mLarge);
+                    auto cont = dispatch(buffer.data.get(), frameSize);
+                    mPool.release(std::move(buffer));
+                    if (cont) {
+                        process();
+                    }
+                });
+    }
+
+    bool dispatch(const uint8_t* frame, size_t frameSize) {
+        if (mHandler(error_code(), frame, frameSize)) {
+            return true;
+        }
+        mActive = false;
+        return false;
+    }
+
+    void fail(const error_code& ec) {
+        mActive = false;
+        mHandler(ec, nullptr, 0);
+    }
+
+    boost::asio::ip::tcp::socket& mSocket;
+    BufferPool& mPool;
+    size_t mMinFrameSize;
+    size_t mMaxFrameSize;
+    handler_type mHandler;
+    size_t mBufferSize;
+    std::unique_ptr<uint8_t[]> mBuffer;
+    size_t mBegin;
+    size_t mEnd;
+    bool mActive;
+    BufferPool::Buffer mLarge;
+};
+
+} // namespace protocol
+} // namespace crossbow
@@ -0,0 +1,222 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/Protocol.hpp>
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+
+namespace crossbow {
+namespace protocol {
+
+/**
+ * @brief Server front end accepting connections and distributing them over multiple io_service threads
+ *
+ * Every thread runs its own io_service (shard), accepted connections are assigned to the shards in a round robin
+ * fashion and are served by a protocol::Server on that shard only. With reusePort enabled, every shard accepts on its
+ * own socket bound with SO_REUSEPORT and the kernel distributes the incoming connections.
+ *
+ * A new Implementation is created by the factory for every connection (called on the thread of the shard). Closed
+ * connections are destroyed after Implementation::close() returned.
+ */
+template<template <typename> class Cmd_Switch,
+         class Command,
+         template <Command> class Signature,
+         class Implementation>
+class ShardedServer {
+public:
+    using server_type = Server<Cmd_Switch, Command, Signature, Implementation>;
+    using factory_type = std::function<std::unique_ptr<Implementation>(size_t shard)>;
+
+    /**
+     * @param endpoint The endpoint to listen on (port 0 chooses a free port)
+     * @param numThreads Number of io_service threads (0 for the number of hardware threads)
+     * @param factory Creates the implementation for a new connection
+     * @param reusePort Whether every shard should accept on its own socket using SO_REUSEPORT
+     */
+    ShardedServer(const boost::asio::ip::tcp::endpoint& endpoint, size_t numThreads, factory_type factory,
+            bool reusePort = false)
+        : mFactory(std::move(factory))
+        , mReusePort(reusePort)
+        , mNextShard(0)
+        , mConnections(0)
+    {
+        if (numThreads == 0) {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        mShards.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            mShards.emplace_back(new Shard(i));
+        }
+
+        mEndpoint = endpoint;
+        auto numAcceptors = (reusePort ? numThreads : 1);
+        for (size_t i = 0; i < numAcceptors; ++i) {
+            auto& shard = *mShards[i];
+            shard.acceptor.reset(new boost::asio::ip::tcp::acceptor(shard.service));
+            shard.acceptor->open(mEndpoint.protocol());
+            shard.acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            if (reusePort) {
+                shard.acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+            }
+            shard.acceptor->bind(mEndpoint);
+            shard.acceptor->listen();
+            // Further acceptors have to bind to the port chosen by the first one
+            mEndpoint = shard.acceptor->local_endpoint();
+        }
+    }
+
+    ~ShardedServer() {
+        stop();
+    }
+
+    /**
+     * @brief The endpoint the server is listening on
+     */
+    const boost::asio::ip::tcp::endpoint& localEndpoint() const {
+        return mEndpoint;
+    }
+
+    /**
+     * @brief Number of currently open connections
+     */
+    size_t connections() const {
+        return mConnections.load();
+    }
+
+    /**
+     * @brief Starts accepting connections and spawns the io_service threads
+     */
+    void start() {
+        for (auto& s : mShards) {
+            if (s->acceptor) {
+                accept(*s);
+            }
+        }
+        for (auto& s : mShards) {
+            auto& shard = *s;
+            shard.thread = std::thread([&shard] () {
+                shard.service.run();
+            });
+        }
+    }
+
+    /**
+     * @brief Stops all io_services and waits for the threads to terminate
+     */
+    void stop() {
+        for (auto& s : mShards) {
+            s->work.reset();
+            s->service.stop();
+        }
+        for (auto& s : mShards) {
+            if (s->thread.joinable()) {
+                s->thread.join();
+            }
+        }
+    }
+
+private:
+    struct Connection {
+        Connection(boost::asio::io_service& service)
+            : socket(service)
+        {}
+
+        boost::asio::ip::tcp::socket socket;
+        std::unique_ptr<Implementation> impl;
+        std::unique_ptr<server_type> server;
+    };
+
+    struct Shard {
+        Shard(size_t i)
+            : id(i)
+            , work(new boost::asio::io_service::work(service))
+        {}
+
+        size_t id;
+        boost::asio::io_service service;
+        std::unique_ptr<boost::asio::io_service::work> work;
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+        /// Open connections of this shard, only accessed from the thread of the shard
+        std::unordered_map<Connection*, std::shared_ptr<Connection>> connections;
+        std::thread thread;
+    };
+
+    void accept(Shard& acceptShard) {
+        // Without SO_REUSEPORT the connections are distributed round robin, else they stay on the accepting shard
+        auto& shard = (mReusePort ? acceptShard : *mShards[mNextShard++ % mShards.size()]);
+        std::shared_ptr<Connection> connection(new Connection(shard.service));
+        acceptShard.acceptor->async_accept(connection->socket, [this, &acceptShard, &shard, connection]
+                (const boost::system::error_code& ec) {
+            if (ec) {
+                if (ec != boost::asio::error::operation_aborted) {
+                    accept(acceptShard);
+                }
+                return;
+            }
+            // Hand the connection over to the thread of its shard
+            shard.service.post([this, &shard, connection] () {
+                startConnection(shard, connection);
+            });
+            accept(acceptShard);
+        });
+    }
+
+    void startConnection(Shard& shard, const std::shared_ptr<Connection>& connection) {
+        auto conn = connection.get();
+        boost::system::error_code ec;
+        conn->socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+        conn->impl = mFactory(shard.id);
+        conn->server.reset(new server_type(*conn->impl, conn->socket, [this, &shard, conn] () {
+            // The connection can not be destroyed from within its own handler
+            shard.service.post([this, &shard, conn] () {
+                shard.connections.erase(conn);
+                --mConnections;
+            });
+        }));
+        ++mConnections;
+        shard.connections.emplace(conn, connection);
+        conn->server->run();
+    }
+
+    factory_type mFactory;
+    bool mReusePort;
+    std::vector<std::unique_ptr<Shard>> mShards;
+    boost::asio::ip::tcp::endpoint mEndpoint;
+    size_t mNextShard;
+    std::atomic<size_t> mConnections;
+};
+
+} // namespace protocol
+} // namespace crossbow
@@ -0,0 +1,187 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/protocol/BufferPool.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace crossbow {
+namespace protocol {
+
+/**
+ * @brief Queue of outgoing frames on a socket
+ *
+ * Frames are not written immediately: A flush is scheduled on the io_service so all frames queued while processing the
+ * current handler (e.g. all responses to the requests received in one read) are sent with a single vectored write.
+ * Frames queued while a write is in progress are sent together once the write completes. The buffers are returned to
+ * the pool after they were written. The queue is not thread safe.
+ *
+ * Handlers still pending on the io_service when the queue is destroyed are ignored. If a write is in progress the
+ * socket has to be closed before the queue is destroyed.
+ */
+class WriteQueue {
+public:
+    using error_code = boost::system::error_code;
+
+    /**
+     * @param service The io_service of the socket
+     * @param socket The socket to write to
+     * @param pool Pool the written buffers are returned to
+     * @param errorHandler Invoked when a write fails, all queued frames are dropped
+     * @param maxBatchSize Maximum number of frames sent with a single write
+     */
+    WriteQueue(boost::asio::io_service& service, boost::asio::ip::tcp::socket& socket, BufferPool& pool,
+            std::function<void(const error_code&)> errorHandler, size_t maxBatchSize = 64)
+        : mService(service)
+        , mSocket(socket)
+        , mPool(pool)
+        , mErrorHandler(std::move(errorHandler))
+        , mMaxBatchSize(maxBatchSize == 0 ? 1 : maxBatchSize)
+        , mWriting(false)
+        , mFlush(false)
+        , mAlive(std::make_shared<bool>(true))
+    {}
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    /**
+     * @brief Number of frames not yet written
+     */
+    size_t size() const {
+        return mQueue.size() + mInFlight.size();
+    }
+
+    /**
+     * @brief Queues the first size bytes of the buffer for writing
+     */
+    void write(BufferPool::Buffer buffer, size_t size) {
+        mQueue.emplace_back(std::move(buffer), size);
+        scheduleFlush();
+    }
+
+    /**
+     * @brief Invokes the handler once all frames queued so far were written
+     *
+     * The handler is also invoked if the write fails. It is invoked immediately if no frames are queued.
+     */
+    void onFlushed(std::function<void()> handler) {
+        mFlushedHandler = std::move(handler);
+        if (size() == 0) {
+            flushed();
+        }
+    }
+
+private:
+    void flushed() {
+        if (!mFlushedHandler) {
+            return;
+        }
+        auto handler = std::move(mFlushedHandler);
+        mFlushedHandler = nullptr;
+        handler();
+    }
+
+    void scheduleFlush() {
+        if (mWriting || mFlush) {
+            return;
+        }
+        mFlush = true;
+        std::weak_ptr<bool> alive = mAlive;
+        mService.post([this, alive] () {
+            if (alive.expired()) {
+                return;
+            }
+            mFlush = false;
+            flush();
+        });
+    }
+
+    void flush() {
+        if (mWriting) {
+            return;
+        }
+        if (mQueue.empty()) {
+            flushed();
+            return;
+        }
+        if (!mSocket.is_open()) {
+            mQueue.clear();
+            flushed();
+            return;
+        }
+        auto count = std::min(mQueue.size(), mMaxBatchSize);
+        mBuffers.clear();
+        for (size_t i = 0; i < count; ++i) {
+            mBuffers.emplace_back(mQueue.front().first.data.get(), mQueue.front().second);
+            mInFlight.emplace_back(std::move(mQueue.front()));
+            mQueue.pop_front();
+        }
+
+        mWriting = true;
+        std::weak_ptr<bool> alive = mAlive;
+        boost::asio::async_write(mSocket, mBuffers, [this, alive] (const error_code& ec, size_t) {
+            if (alive.expired()) {
+                return;
+            }
+            mWriting = false;
+            for (auto& e : mInFlight) {
+                mPool.release(std::move(e.first));
+            }
+            mInFlight.clear();
+            if (ec) {
+                mQueue.clear();
+                mErrorHandler(ec);
+                flushed();
+                return;
+            }
+            flush();
+        });
+    }
+
+    boost::asio::io_service& mService;
+    boost::asio::ip::tcp::socket& mSocket;
+    BufferPool& mPool;
+    std::function<void(const error_code&)> mErrorHandler;
+    size_t mMaxBatchSize;
+    bool mWriting;
+    bool mFlush;
+    std::deque<std::pair<BufferPool::Buffer, size_t>> mQueue;
+    std::vector<std::pair<BufferPool::Buffer, size_t>> mInFlight;
+    std::vector<boost::asio::const_buffer> mBuffers;
+    std::function<void()> mFlushedHandler;
+    /// Pending handlers hold a weak reference to detect that the queue was destroyed
+    std::shared_ptr<bool> mAlive;
+};
+
+} // namespace protocol
+} // namespace crossbow
@@ -0,0 +1,248 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "Serializer.hpp"
+
+#include <crossbow/byte_buffer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace crossbow {
+
+/**
+ * @brief Segments for a buffer_serializer restricted to the initial buffer
+ *
+ * Serializing an object not fitting into the initial buffer fails with std::length_error.
+ */
+struct single_buffer_segments {
+    buffer_writer acquire() {
+        return buffer_writer(static_cast<char*>(nullptr), 0);
+    }
+
+    void append(const char*, size_t) {
+    }
+};
+
+/**
+ * @brief Archiver serializing objects directly into a crossbow::buffer_writer
+ *
+ * Whenever an object does not fit into the remaining space of the current buffer, a new buffer is acquired from the
+ * Segments object. The Segments class has to provide the following two functions:
+ *
+ * - buffer_writer acquire(): Returns a new empty buffer (a buffer of length 0 if no more buffers are available)
+ * - void append(const char* data, size_t length): Invoked for every buffer after serialization into it is done
+ *
+ * The concatenation of all appended buffers forms the same byte sequence the crossbow::serializer produces. Objects
+ * are only split across buffers at element boundaries, this means that a buffer might not be used completely. Leaves
+ * (types with a splittable split_policy and flat types) are written as a whole, leaves too big for a single buffer
+ * (e.g. long strings) are copied piecewise as described by their split_policy. Flat types too big for a single buffer
+ * are serialized into a temporary buffer first.
+ *
+ * Only leaves are sized, all other objects are serialized element by element. The buffer writer passed
+ * in the constructor is left untouched until flush() advances it past the data written into it.
+ */
+template<typename Segments = single_buffer_segments>
+struct buffer_serializer {
+    uint8_t* pos;
+
+    buffer_serializer(buffer_writer& writer, Segments& segments)
+            : pos(reinterpret_cast<uint8_t*>(writer.data())),
+              mWriter(writer),
+              mSegments(segments),
+              mBegin(pos),
+              mEnd(reinterpret_cast<const uint8_t*>(writer.end())),
+              mInitial(true),
+              mInitialLength(0) {
+    }
+
+    template<typename T>
+    typename std::enable_if<is_flat_serializable<T>::value, buffer_serializer&>::type operator& (const T& obj) {
+        constexpr auto size = flat_layout<T>::size();
+        if (!fits(size)) {
+            writeLeaf(obj, size);
+            return *this;
+        }
+        flat_layout<T>::write(obj, pos);
+        pos += size;
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<!is_flat_serializable<T>::value && !has_visit<T>::value, buffer_serializer&>::type
+    operator& (const T& obj) {
+        serializeObject(obj, std::integral_constant<bool, split_policy<T>::splittable>());
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<!is_flat_serializable<T>::value && has_visit<T>::value, buffer_serializer&>::type
+    operator& (const T& o) {
+        auto& obj = reinterpret_cast<const serializable<T>&>(o);
+        obj.visit(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Completes the current buffer
+     *
+     * Must be called after the last object was serialized.
+     */
+    void flush() {
+        auto length = static_cast<size_t>(pos - mBegin);
+        mSegments.append(reinterpret_cast<const char*>(mBegin), length);
+        mBegin = pos;
+        if (mInitial) {
+            mInitialLength += length;
+        }
+        mWriter.advance(mInitialLength);
+        mInitialLength = 0;
+    }
+
+private:
+    struct byte_writer {
+        buffer_serializer& ser;
+
+        void operator() (const void* data, size_t length) {
+            ser.writeBytes(static_cast<const uint8_t*>(data), length);
+        }
+    };
+
+    bool fits(size_t length) const {
+        return static_cast<size_t>(mEnd - pos) >= length;
+    }
+
+    void nextSegment() {
+        auto length = static_cast<size_t>(pos - mBegin);
+        mSegments.append(reinterpret_cast<const char*>(mBegin), length);
+        if (mInitial) {
+            mInitialLength += length;
+            mInitial = false;
+        }
+        auto writer = mSegments.acquire();
+        if (writer.end() == writer.data()) {
+            throw std::length_error("No buffer available to serialize object");
+        }
+        pos = reinterpret_cast<uint8_t*>(writer.data());
+        mBegin = pos;
+        mEnd = reinterpret_cast<const uint8_t*>(writer.end());
+    }
+
+    /**
+     * @brief Writes a leaf, leaves are marked by their split_policy and write their data directly
+     */
+    template<typename T>
+    void serializeObject(const T& obj, std::true_type) {
+        sizer s;
+        size_policy<sizer, T> p;
+        writeLeaf(obj, p(s, obj));
+    }
+
+    /**
+     * @brief Serializes all other objects element by element through the archiver
+     */
+    template<typename T>
+    void serializeObject(const T& obj, std::false_type) {
+        serialize_policy<buffer_serializer<Segments>, T> ser;
+        pos = ser(*this, obj, pos);
+    }
+
+    template<typename T>
+    void writeLeaf(const T& obj, size_t length) {
+        if (!fits(length)) {
+            nextSegment();
+        }
+        if (fits(length)) {
+            serializer_into_array ser(pos);
+            ser & obj;
+            pos = ser.pos;
+            return;
+        }
+        splitLeaf(obj, length);
+    }
+
+    /**
+     * @brief Writes a leaf bigger than a whole buffer
+     */
+    template<typename T>
+    typename std::enable_if<split_policy<T>::splittable>::type splitLeaf(const T& obj, size_t) {
+        byte_writer writer{*this};
+        split_policy<T> split;
+        split(writer, obj);
+    }
+
+    template<typename T>
+    typename std::enable_if<!split_policy<T>::splittable>::type splitLeaf(const T& obj, size_t length) {
+        serializer ser(length);
+        ser & obj;
+        writeBytes(ser.buffer.get(), length);
+    }
+
+    void writeBytes(const uint8_t* src, size_t length) {
+        while (length != 0) {
+            if (pos == mEnd) {
+                nextSegment();
+            }
+            auto count = std::min(length, static_cast<size_t>(mEnd - pos));
+            memcpy(pos, src, count);
+            pos += count;
+            src += count;
+            length -= count;
+        }
+    }
+
+    buffer_writer& mWriter;
+    Segments& mSegments;
+    const uint8_t* mBegin;
+    const uint8_t* mEnd;
+    bool mInitial;
+    size_t mInitialLength;
+};
+
+/**
+ * @brief Serializes the object into the buffer writer
+ *
+ * @exception std::length_error In case the object does not fit into the buffer
+ */
+template<typename T>
+void serialize(buffer_writer& writer, const T& obj) {
+    single_buffer_segments segments;
+    buffer_serializer<> ser(writer, segments);
+    ser & obj;
+    ser.flush();
+}
+
+/**
+ * @brief Serializes the object into the buffer writer spanning new buffers acquired from the segments if needed
+ *
+ * @exception std::length_error In case the segments do not provide enough buffers
+ */
+template<typename T, typename Segments>
+void serialize(buffer_writer& writer, const T& obj, Segments& segments) {
+    buffer_serializer<Segments> ser(writer, segments);
+    ser & obj;
+    ser.flush();
+}
+
+} // namespace crossbow
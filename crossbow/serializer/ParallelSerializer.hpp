@@ -0,0 +1,181 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include "Serializer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace crossbow {
+namespace impl {
+
+template<typename T>
+struct has_mapped_type_helper {
+    template<typename U>
+    static std::true_type check(typename U::mapped_type*);
+
+    template<typename U>
+    static std::false_type check(...);
+
+    using type = decltype(check<T>(nullptr));
+};
+
+/**
+ * @brief Serializes a single element of a sequence container
+ */
+template<typename Container, bool Associative = has_mapped_type_helper<Container>::type::value>
+struct parallel_element {
+    template<typename Archiver, typename T>
+    static void exec(Archiver& ar, const T& e) {
+        ar & e;
+    }
+};
+
+/**
+ * @brief Serializes a single element of an associative container (key followed by value)
+ */
+template<typename Container>
+struct parallel_element<Container, true> {
+    template<typename Archiver, typename T>
+    static void exec(Archiver& ar, const T& e) {
+        ar & e.first;
+        ar & e.second;
+    }
+};
+
+/**
+ * @brief Executes fun(i) for every i in [0, count) each on its own thread
+ *
+ * The first invocation is executed on the calling thread. The first exception thrown by any invocation is rethrown
+ * after all threads have finished.
+ */
+template<typename Fun>
+void parallel_for(std::size_t count, Fun fun) {
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+    for (std::size_t i = 1; i < count; ++i) {
+        threads.emplace_back([&fun, &errors, i] () {
+            try {
+                fun(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    try {
+        fun(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+} // namespace impl
+
+/**
+ * @brief Serializes a large container using multiple threads
+ *
+ * The container is split into chunks of consecutive elements which are sized in parallel. The offsets of the chunks in
+ * the output buffer are computed by a prefix sum over the chunk sizes, then all chunks are serialized in parallel into
+ * the same buffer. The result is byte identical to crossbow::serialize.
+ *
+ * Supports all containers serialized as element count followed by the elements (e.g. std::vector, std::map,
+ * std::multimap and std::unordered_map). The container must not be modified during serialization.
+ *
+ * @param res The buffer holding the serialized container
+ * @param container The container to serialize
+ * @param numThreads Maximum number of threads to use (0 for the number of hardware threads)
+ * @param minChunk Minimum number of elements per thread, containers too small fall back to sequential serialization
+ * @return The size of the serialized data
+ */
+template<typename Container>
+std::size_t parallel_serialize(std::unique_ptr<uint8_t[]>& res, const Container& container, unsigned numThreads = 0,
+        std::size_t minChunk = 0x4000u) {
+    using element = impl::parallel_element<Container>;
+    using iterator = typename Container::const_iterator;
+
+    if (numThreads == 0) {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    std::size_t count = container.size();
+    auto chunks = std::min(static_cast<std::size_t>(numThreads), count / std::max(minChunk, std::size_t(1)));
+    if (chunks <= 1) {
+        return serialize(res, container);
+    }
+
+    // Chunk boundaries (linear for non random access iterators but cheap compared to the serialization)
+    std::vector<iterator> bounds;
+    bounds.reserve(chunks + 1);
+    auto iter = container.begin();
+    for (std::size_t i = 0; i < chunks; ++i) {
+        bounds.emplace_back(iter);
+        std::advance(iter, count / chunks + (i < count % chunks ? 1 : 0));
+    }
+    bounds.emplace_back(container.end());
+
+    // Size all chunks and compute their offsets
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+    impl::parallel_for(chunks, [&bounds, &offsets] (std::size_t i) {
+        sizer s;
+        for (auto e = bounds[i]; e != bounds[i + 1]; ++e) {
+            element::exec(s, *e);
+        }
+        offsets[i + 1] = s.size;
+    });
+    offsets[0] = sizeof(std::size_t);
+    for (std::size_t i = 1; i <= chunks; ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    auto size = offsets[chunks];
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+    serializer_into_array header(buffer.get());
+    header & count;
+
+    auto data = buffer.get();
+    impl::parallel_for(chunks, [&bounds, &offsets, data] (std::size_t i) {
+        serializer_into_array ser(data + offsets[i]);
+        for (auto e = bounds[i]; e != bounds[i + 1]; ++e) {
+            element::exec(ser, *e);
+        }
+        assert(ser.pos == data + offsets[i + 1]);
+    });
+
+    res = std::move(buffer);
+    return size;
+}
+
+} // namespace crossbow
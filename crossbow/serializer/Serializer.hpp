@@ -85,6 +85,180 @@ struct has_visit {
     static constexpr bool value = value_type::value;
 };
 
+/**
+ * @brief Describes a data member of a flat serializable type
+ *
+ * Use the CROSSBOW_MEMBER macro to declare a member.
+ */
+template<class T, class U, U T::* Ptr>
+struct member {
+    using class_type = T;
+    using value_type = U;
+
+    static const U& get(const T& obj) {
+        return obj.*Ptr;
+    }
+
+    static U& get(T& obj) {
+        return obj.*Ptr;
+    }
+
+    static std::size_t offset(const T& obj) {
+        return static_cast<std::size_t>(reinterpret_cast<const char*>(&(obj.*Ptr))
+                - reinterpret_cast<const char*>(&obj));
+    }
+};
+
+/**
+ * @brief List of members a type is made of
+ *
+ * A class declaring its members as
+ *
+ *     using serializable_members = crossbow::member_list<CROSSBOW_MEMBER(Foo, a), CROSSBOW_MEMBER(Foo, b)>;
+ *
+ * where all members are arithmetic types (except bool), enums or again such classes is a flat type. Flat types are
+ * serialized without going through visit: The sizer returns a compile-time constant and the members are copied with
+ * constant offsets (or with a single memcpy if the struct has no padding). The produced bytes are the same as when
+ * visiting the members in the listed order, so a type may provide both a visit function and a member list as long as
+ * the orders match.
+ */
+template<class... Members>
+struct member_list {};
+
+#define CROSSBOW_MEMBER(Type, name) crossbow::member<Type, decltype(Type::name), &Type::name>
+
+template<class T>
+struct serializable_members {
+    template<class C>
+    static typename C::serializable_members test(typename C::serializable_members*);
+    template<class>
+    static void test(...);
+
+    using type = decltype(test<T>(nullptr));
+};
+
+template<class T, class Members = typename serializable_members<T>::type>
+struct flat_layout {
+    constexpr static bool value = (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value)
+            || std::is_enum<T>::value;
+
+    static constexpr std::size_t size() {
+        return sizeof(T);
+    }
+
+    static bool packed(const T&) {
+        return true;
+    }
+
+    static void write(const T& obj, uint8_t* pos) {
+        memcpy(pos, &obj, sizeof(T));
+    }
+
+    static void read(T& obj, const uint8_t* pos) {
+        memcpy(&obj, pos, sizeof(T));
+    }
+};
+
+template<std::size_t Offset, class... Members>
+struct flat_members;
+
+template<std::size_t Offset, class Head, class... Tail>
+struct flat_members<Offset, Head, Tail...> {
+    using value_type = typename Head::value_type;
+    using layout = flat_layout<value_type>;
+    using rest = flat_members<Offset + layout::size(), Tail...>;
+
+    constexpr static bool value = layout::value && rest::value;
+
+    static constexpr std::size_t size() {
+        return rest::size();
+    }
+
+    template<class T>
+    static bool packed(const T& obj) {
+        return Head::offset(obj) == Offset && layout::packed(Head::get(obj)) && rest::packed(obj);
+    }
+
+    template<class T>
+    static void write(const T& obj, uint8_t* pos) {
+        layout::write(Head::get(obj), pos + Offset);
+        rest::write(obj, pos);
+    }
+
+    template<class T>
+    static void read(T& obj, const uint8_t* pos) {
+        layout::read(Head::get(obj), pos + Offset);
+        rest::read(obj, pos);
+    }
+};
+
+template<std::size_t Offset>
+struct flat_members<Offset> {
+    constexpr static bool value = true;
+
+    static constexpr std::size_t size() {
+        return Offset;
+    }
+
+    template<class T>
+    static bool packed(const T&) {
+        return true;
+    }
+
+    template<class T>
+    static void write(const T&, uint8_t*) {}
+
+    template<class T>
+    static void read(T&, const uint8_t*) {}
+};
+
+template<class T, class... Members>
+struct flat_layout<T, member_list<Members...>> {
+    using members = flat_members<0, Members...>;
+
+    constexpr static bool value = members::value;
+
+    static constexpr std::size_t size() {
+        return members::size();
+    }
+
+    // Whether the object can be copied with a single memcpy: The members follow each other without padding
+    // (member offsets are taken from the object at run time, C++11 has no constant expression for them)
+    static bool packed(const T& obj) {
+        return sizeof(T) == size() && members::packed(obj);
+    }
+
+    static void write(const T& obj, uint8_t* pos) {
+        if (packed(obj)) {
+            memcpy(pos, &obj, sizeof(T));
+        } else {
+            members::write(obj, pos);
+        }
+    }
+
+    static void read(T& obj, const uint8_t* pos) {
+        if (packed(obj)) {
+            memcpy(&obj, pos, sizeof(T));
+        } else {
+            members::read(obj, pos);
+        }
+    }
+};
+
+template<class T>
+struct is_flat_serializable {
+    constexpr static bool value = std::is_class<T>::value && flat_layout<T>::value;
+};
+
+/**
+ * @brief The serialized size of a flat type
+ */
+template<class T>
+constexpr std::size_t flat_size() {
+    static_assert(flat_layout<T>::value, "Type is not flat");
+    return flat_layout<T>::size();
+}
+
 template<typename T>
 struct serializable : T
 {
@@ -321,6 +495,33 @@ struct size_policy<Archiver, std::tuple<T...> >
     }
 };
 
+/**
+ * @brief Marks a leaf (an object serialized without nested objects) and emits its bytes as a sequence of ranges
+ *
+ * Lets archivers writing into fixed size buffers write a leaf directly and split a leaf bigger than a buffer without
+ * serializing it into a temporary first. The writer is invoked as writer(const void* data, size_t length) for every
+ * range. Types without a specialization are not leaves and are serialized through the archiver. Types writing directly
+ * into the buffer in their serialize_policy must provide a splittable specialization.
+ */
+template<typename T, typename Enable = void>
+struct split_policy
+{
+    static constexpr bool splittable = false;
+};
+
+template<typename T>
+struct split_policy<T, typename std::enable_if<std::is_pod<T>::value && !implements_serializable<T>()
+        && !is_flat_serializable<T>::value>::type>
+{
+    static constexpr bool splittable = true;
+
+    template<class Writer>
+    void operator() (Writer& writer, const T& obj) const
+    {
+        writer(&obj, sizeof(T));
+    }
+};
+
 struct sizer {
     std::size_t size;
     sizer() : size(0) {}
@@ -341,9 +542,17 @@ struct sizer {
         }
     };
 
+    template<typename T>
+    struct flat_impl {
+        static void exec(sizer& s, const T&) {
+            s.size += flat_layout<T>::size();
+        }
+    };
+
     template<typename T>
     sizer& operator& (const T& obj) {
-        std::conditional<has_visit<T>::value, visit_impl<T>, other_impl<T>>::type::exec(*this, obj);
+        std::conditional<is_flat_serializable<T>::value, flat_impl<T>,
+                typename std::conditional<has_visit<T>::value, visit_impl<T>, other_impl<T>>::type>::type::exec(*this, obj);
         return *this;
     }
 };
@@ -356,14 +565,21 @@ struct serializer {
     serializer(uint8_t* buf) : buffer(buf), pos(buf) {}
 
     template<typename T>
-    typename std::enable_if<!has_visit<T>::value, serializer&>::type operator& (const T& obj) {
+    typename std::enable_if<is_flat_serializable<T>::value, serializer&>::type operator& (const T& obj) {
+        flat_layout<T>::write(obj, pos);
+        pos += flat_layout<T>::size();
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<!is_flat_serializable<T>::value && !has_visit<T>::value, serializer&>::type operator& (const T& obj) {
         serialize_policy<serializer, T> ser;
         pos = ser(*this, obj, pos);
         return *this;
     }
 
     template<typename T>
-    typename std::enable_if<has_visit<T>::value, serializer&>::type operator& (const T& o) {
+    typename std::enable_if<!is_flat_serializable<T>::value && has_visit<T>::value, serializer&>::type operator& (const T& o) {
         auto& obj = reinterpret_cast<const serializable<T>&>(o);
         obj.visit(*this);
         return *this;
@@ -377,14 +593,21 @@ struct serializer_into_array {
     serializer_into_array(uint8_t* b) : buffer(b), pos(buffer) {}
     
     template<typename T>
-    typename std::enable_if<!has_visit<T>::value, serializer_into_array&>::type operator& (const T& obj) {
+    typename std::enable_if<is_flat_serializable<T>::value, serializer_into_array&>::type operator& (const T& obj) {
+        flat_layout<T>::write(obj, pos);
+        pos += flat_layout<T>::size();
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<!is_flat_serializable<T>::value && !has_visit<T>::value, serializer_into_array&>::type operator& (const T& obj) {
         serialize_policy<serializer_into_array, T> ser;
         pos = ser(*this, obj, pos);
         return *this;
     }
     
     template<typename T>
-    typename std::enable_if<has_visit<T>::value, serializer_into_array&>::type operator& (const T& o) {
+    typename std::enable_if<!is_flat_serializable<T>::value && has_visit<T>::value, serializer_into_array&>::type operator& (const T& o) {
         auto& obj = reinterpret_cast<const serializable<T>&>(o);
         obj.visit(*this);
         return *this;
@@ -397,14 +620,21 @@ struct deserializer {
     deserializer(const uint8_t* buffer) : pos(buffer) {}
 
     template<typename T>
-    typename std::enable_if<!has_visit<T>::value, deserializer&>::type operator& (T& obj) {
+    typename std::enable_if<is_flat_serializable<T>::value, deserializer&>::type operator& (T& obj) {
+        flat_layout<T>::read(obj, pos);
+        pos += flat_layout<T>::size();
+        return *this;
+    }
+
+    template<typename T>
+    typename std::enable_if<!is_flat_serializable<T>::value && !has_visit<T>::value, deserializer&>::type operator& (T& obj) {
         deserialize_policy<deserializer, T> ser;
         pos = ser(*this, obj, pos);
         return *this;
     }
 
     template<typename T>
-    typename std::enable_if<has_visit<T>::value, deserializer&>::type operator& (T& obj) {
+    typename std::enable_if<!is_flat_serializable<T>::value && has_visit<T>::value, deserializer&>::type operator& (T& obj) {
         obj.visit(*this);
         return *this;
     }
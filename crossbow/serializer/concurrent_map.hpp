@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+#include "unordered_map.hpp"
+#include <crossbow/concurrent_map.hpp>
+
+namespace crossbow {
+
+/**
+ * @brief Policies for crossbow::concurrent_map
+ *
+ * The map must not be modified concurrently while it is being serialized, as the element count is written before the
+ * elements.
+ */
+template<class Archiver, class Key, class Value, class Hash, class KeyEqual, class Allocator, class MutexType,
+        size_t ConcurrencyLevel, size_t InitialCapacity, size_t LoadFactor>
+struct serialize_policy<Archiver, concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType, ConcurrencyLevel,
+        InitialCapacity, LoadFactor>>
+{
+    using type = concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType, ConcurrencyLevel, InitialCapacity,
+            LoadFactor>;
+    uint8_t* operator() (Archiver& ar, const type& map, uint8_t* pos) const {
+        auto& m = const_cast<type&>(map);
+        std::size_t s = m.size();
+        ar & s;
+        m.for_each([&ar](const Key& key, const Value& value) {
+            ar & key;
+            ar & value;
+        });
+        return ar.pos;
+    }
+};
+
+template<class Archiver, class Key, class Value, class Hash, class KeyEqual, class Allocator, class MutexType,
+        size_t ConcurrencyLevel, size_t InitialCapacity, size_t LoadFactor>
+struct deserialize_policy<Archiver, concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType, ConcurrencyLevel,
+        InitialCapacity, LoadFactor>>
+        : hash_map_deserialize_policy<Archiver, concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType,
+                ConcurrencyLevel, InitialCapacity, LoadFactor>>
+{
+};
+
+template<class Archiver, class Key, class Value, class Hash, class KeyEqual, class Allocator, class MutexType,
+        size_t ConcurrencyLevel, size_t InitialCapacity, size_t LoadFactor>
+struct size_policy<Archiver, concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType, ConcurrencyLevel,
+        InitialCapacity, LoadFactor>>
+{
+    using type = concurrent_map<Key, Value, Hash, KeyEqual, Allocator, MutexType, ConcurrencyLevel, InitialCapacity,
+            LoadFactor>;
+    std::size_t operator() (Archiver& ar, const type& map) const {
+        auto& m = const_cast<type&>(map);
+        std::size_t s = 0;
+        ar & s;
+        m.for_each([&ar](const Key& key, const Value& value) {
+            ar & key;
+            ar & value;
+        });
+        return 0;
+    }
+};
+
+} // namespace crossbow
@@ -47,7 +47,7 @@ struct deserialize_policy<Archiver, crossbow::basic_string<Char, Traits, Allocat
     const uint8_t* operator() (Archiver&, type& out, const uint8_t* ptr) const
     {
         const std::uint32_t s = *reinterpret_cast<const std::uint32_t*>(ptr);
-        out = crossbow::string(reinterpret_cast<const char*>(ptr + sizeof(std::uint32_t)), s);
+        out.assign(reinterpret_cast<const Char*>(ptr + sizeof(std::uint32_t)), s);
         return ptr + sizeof(s) + s;
     }
 };
@@ -62,4 +62,19 @@ struct size_policy<Archiver, crossbow::basic_string<Char, Traits, Allocator>>
     }
 };
 
+template<class Char, class Traits, class Allocator>
+struct split_policy<crossbow::basic_string<Char, Traits, Allocator>>
+{
+    using type = crossbow::basic_string<Char, Traits, Allocator>;
+    static constexpr bool splittable = true;
+
+    template<class Writer>
+    void operator() (Writer& writer, const type& obj) const
+    {
+        uint32_t len = uint32_t(obj.size());
+        writer(&len, sizeof(std::uint32_t));
+        writer(obj.data(), len);
+    }
+};
+
 } // namespace crossbow
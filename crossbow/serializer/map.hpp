@@ -53,7 +53,8 @@ struct deserialize_policy<Archiver, std::map<Key, Value, Predicate, Allocator>>
             Value s;
             ar & f;
             ar & s;
-            out.emplace(std::move(f), std::move(s));
+            // The data was serialized in order: Every element is inserted at the end
+            out.emplace_hint(out.end(), std::move(f), std::move(s));
         }
         return ar.pos;
     }
@@ -101,7 +102,8 @@ struct deserialize_policy<Archiver, std::multimap<Key, Value, Predicate, Allocat
             Value s;
             ar & f;
             ar & s;
-            out.emplace(std::move(f), std::move(s));
+            // The data was serialized in order: Every element is inserted at the end
+            out.emplace_hint(out.end(), std::move(f), std::move(s));
         }
         return ar.pos;
     }
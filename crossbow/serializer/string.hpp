@@ -62,5 +62,20 @@ struct size_policy<Archiver, std::basic_string<Char, Traits, Allocator>>
     }
 };
 
+template<class Char, class Traits, class Allocator>
+struct split_policy<std::basic_string<Char, Traits, Allocator>>
+{
+    using type = std::basic_string<Char, Traits, Allocator>;
+    static constexpr bool splittable = true;
+
+    template<class Writer>
+    void operator() (Writer& writer, const type& obj) const
+    {
+        uint32_t len = uint32_t(obj.size());
+        writer(&len, sizeof(std::uint32_t));
+        writer(obj.data(), len);
+    }
+};
+
 } // namespace crossbow
 
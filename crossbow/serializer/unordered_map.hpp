@@ -23,14 +23,66 @@
 #pragma once
 #include "Serializer.hpp"
 #include <unordered_map>
+#include <utility>
 
 namespace crossbow {
+namespace impl {
 
-template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
-struct serialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+template<typename Map>
+struct has_reserve {
+    template<typename U>
+    static auto check(U* map) -> decltype(map->reserve(std::size_t(0)), std::true_type());
+
+    template<typename U>
+    static std::false_type check(...);
+
+    static constexpr bool value = decltype(check<Map>(nullptr))::value;
+};
+
+template<typename Map>
+typename std::enable_if<has_reserve<Map>::value>::type reserve(Map& map, std::size_t count) {
+    map.reserve(count);
+}
+
+template<typename Map>
+typename std::enable_if<!has_reserve<Map>::value>::type reserve(Map&, std::size_t) {
+}
+
+template<typename Map>
+struct has_emplace {
+    template<typename U>
+    static auto check(U* map) -> decltype(map->emplace(std::declval<typename U::key_type>(),
+            std::declval<typename U::mapped_type>()), std::true_type());
+
+    template<typename U>
+    static std::false_type check(...);
+
+    static constexpr bool value = decltype(check<Map>(nullptr))::value;
+};
+
+template<typename Map, typename Key, typename Value>
+typename std::enable_if<has_emplace<Map>::value>::type emplace(Map& map, Key&& key, Value&& value) {
+    map.emplace(std::forward<Key>(key), std::forward<Value>(value));
+}
+
+template<typename Map, typename Key, typename Value>
+typename std::enable_if<!has_emplace<Map>::value>::type emplace(Map& map, Key&& key, Value&& value) {
+    map.insert(std::forward<Key>(key), std::forward<Value>(value));
+}
+
+} // namespace impl
+
+/**
+ * @brief Policies for hash maps providing iteration over key-value pairs, size() and emplace(key, value)
+ *
+ * Maps providing reserve(count) are resized once before inserting the elements, maps without emplace are filled
+ * through insert(key, value). Custom hash maps can be serialized by
+ * deriving the serialize_policy, deserialize_policy and size_policy specializations from these classes.
+ */
+template<class Archiver, class Map>
+struct hash_map_serialize_policy
 {
-    using type = std::unordered_map<Key, Value, Hash, Predicate, Allocator>;
-    uint8_t* operator() (Archiver& ar, const type& map, uint8_t* pos) const {
+    uint8_t* operator() (Archiver& ar, const Map& map, uint8_t* pos) const {
         std::size_t s = map.size();
         ar & s;
         for (const auto& e : map) {
@@ -41,29 +93,30 @@ struct serialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate
     }
 };
 
-template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
-struct deserialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+template<class Archiver, class Map>
+struct hash_map_deserialize_policy
 {
-    using type = std::unordered_map<Key, Value, Hash, Predicate, Allocator>;
-    const uint8_t* operator() (Archiver& ar, type& out, const uint8_t* ptr) const {
+    const uint8_t* operator() (Archiver& ar, Map& out, const uint8_t* ptr) const {
+        using key_type = typename Map::key_type;
+        using mapped_type = typename Map::mapped_type;
         size_t sz;
         ar & sz;
+        impl::reserve(out, out.size() + sz);
         for (size_t i = 0; i < sz; ++i) {
-            Key f;
-            Value s;
+            key_type f;
+            mapped_type s;
             ar & f;
             ar & s;
-            out.emplace(std::move(f), std::move(s));
+            impl::emplace(out, std::move(f), std::move(s));
         }
         return ar.pos;
     }
 };
 
-template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
-struct size_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+template<class Archiver, class Map>
+struct hash_map_size_policy
 {
-    using type = std::unordered_map<Key, Value, Hash, Predicate, Allocator>;
-    std::size_t operator() (Archiver& ar, const type& map) const {
+    std::size_t operator() (Archiver& ar, const Map& map) const {
         std::size_t s;
         ar & s;
         for (auto& e : map) {
@@ -74,4 +127,22 @@ struct size_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, All
     }
 };
 
+template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
+struct serialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+        : hash_map_serialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+{
+};
+
+template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
+struct deserialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+        : hash_map_deserialize_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+{
+};
+
+template<class Archiver, class Key, class Value, class Hash, class Predicate, class Allocator>
+struct size_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+        : hash_map_size_policy<Archiver, std::unordered_map<Key, Value, Hash, Predicate, Allocator>>
+{
+};
+
 } // namespace crossbow
@@ -22,6 +22,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <cstdlib>
@@ -144,23 +145,48 @@ struct infinite_lifetime {
 template<typename T>
 struct lifetime_traits {
     static constexpr bool supports_recreation = true;
+    static constexpr bool destroys_instance = true;
 };
 
 template<typename T>
 struct lifetime_traits<infinite_lifetime<T>> {
     static constexpr bool supports_recreation = false;
+    static constexpr bool destroys_instance = false;
 };
 
 template<typename T>
 struct lifetime_traits<default_lifetime<T>> {
     static constexpr bool supports_recreation = false;
+    static constexpr bool destroys_instance = true;
+};
+
+/**
+ * @brief Every access loads the shared instance pointer
+ *
+ * The load has acquire semantics, which is a plain load on x86.
+ */
+template<typename T>
+struct shared_access {
+    static constexpr bool thread_local_cache = false;
+};
+
+/**
+ * @brief Every thread caches the instance pointer in a thread local variable after its first access
+ *
+ * Later accesses are a plain load of the thread local pointer without any synchronization. As the cached pointers can
+ * not be invalidated this can only be used with a lifetime that never destroys the instance.
+ */
+template<typename T>
+struct thread_local_access {
+    static constexpr bool thread_local_cache = true;
 };
 
 template <
 typename Type,
          typename Create = create_static<Type>,
          typename LifetimePolicy = default_lifetime<Type>,
-         typename Mutex = std::mutex >
+         typename Mutex = std::mutex,
+         typename AccessPolicy = shared_access<Type> >
 class singleton {
 public:
     typedef Type value_type;
@@ -170,78 +196,93 @@ public:
     typedef Type &reference;
 private:
     static bool destroyed_;
-    static pointer instance_;
+    static std::atomic<pointer> instance_;
+    static thread_local pointer cached_;
     static Mutex mutex_;
 
     static void destroy() {
         if (destroyed_) return;
-        Create::destroy(instance_);
-        instance_ = nullptr;
+        Create::destroy(instance_.load(std::memory_order_relaxed));
+        instance_.store(nullptr, std::memory_order_release);
         destroyed_ = true;
     }
+
+    static pointer create() {
+        std::lock_guard<Mutex> l(mutex_);
+        auto res = instance_.load(std::memory_order_relaxed);
+        if (!res) {
+            if (destroyed_) {
+                destroyed_ = false;
+                LifetimePolicy::on_dead_ref();
+            }
+            res = Create::create();
+            LifetimePolicy::schedule_destruction(res, &destroy);
+            // Publishes the constructed instance to the acquire load in load()
+            instance_.store(res, std::memory_order_release);
+        }
+        return res;
+    }
+
+    static pointer load() {
+        auto res = instance_.load(std::memory_order_acquire);
+        if (!res) {
+            res = create();
+        }
+        return res;
+    }
 public:
     static reference instance() {
         static_assert(Create::supports_recreation || !lifetime_traits<LifetimePolicy>::supports_recreation,
                       "The creation policy does not support instance recreation, while the lifetime does support it.");
-        if (!instance_) {
-            std::lock_guard<Mutex> l(mutex_);
-            if (!instance_) {
-                if (destroyed_) {
-                    destroyed_ = false;
-                    LifetimePolicy::on_dead_ref();
-                }
-                instance_ = Create::create();
-                LifetimePolicy::schedule_destruction(instance_, &destroy);
+        static_assert(!AccessPolicy::thread_local_cache || !lifetime_traits<LifetimePolicy>::destroys_instance,
+                      "A thread local cache can only be used with a lifetime that never destroys the instance.");
+        if (AccessPolicy::thread_local_cache) {
+            auto res = cached_;
+            if (!res) {
+                res = load();
+                cached_ = res;
             }
+            return *res;
         }
-        return *instance_;
+        return *load();
     }
     /**
      * WARNING: DO NOT EXECUTE THIS MULTITHREADED!!!
      */
     static void destroy_instance() {
-        if (instance_) {
+        if (instance_.load(std::memory_order_acquire)) {
             std::lock_guard<Mutex> l(mutex_);
             destroy();
         }
     }
 public:
     pointer operator-> () {
-        if (!instance_) {
-            instance();
-        }
-        return instance_;
+        return std::addressof(instance());
     }
 
     reference operator* () {
-        if (!instance_) {
-            instance();
-        }
-        return *instance_;
+        return instance();
     }
 
     const_pointer operator-> () const {
-        if (!instance_) {
-            instance();
-        }
-        return instance_;
+        return std::addressof(instance());
     }
 
     const_reference operator*() const {
-        if (!instance_) {
-            instance();
-        }
-        return *instance_;
+        return instance();
     }
 };
 
-template<typename T, typename C, typename L, typename M>
-bool singleton<T, C, L, M>::destroyed_ = false;
+template<typename T, typename C, typename L, typename M, typename A>
+bool singleton<T, C, L, M, A>::destroyed_ = false;
+
+template<typename T, typename C, typename L, typename M, typename A>
+std::atomic<typename singleton<T, C, L, M, A>::pointer> singleton<T, C, L, M, A>::instance_(nullptr);
 
-template<typename T, typename C, typename L, typename M>
-typename singleton<T, C, L, M>::pointer singleton<T, C, L, M>::instance_ = nullptr;
+template<typename T, typename C, typename L, typename M, typename A>
+thread_local typename singleton<T, C, L, M, A>::pointer singleton<T, C, L, M, A>::cached_ = nullptr;
 
-template<typename T, typename C, typename L, typename M>
-M singleton<T, C, L, M>::mutex_;
+template<typename T, typename C, typename L, typename M, typename A>
+M singleton<T, C, L, M, A>::mutex_;
 
 } // namespace crossbow
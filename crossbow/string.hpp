@@ -21,6 +21,8 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #pragma once
+#include <crossbow/hash.hpp>
+#include <crossbow/string_search.hpp>
 #include <string>
 #include <array>
 #include <limits>
@@ -52,70 +54,154 @@ public: // Types
 public: // Constants
     static constexpr size_type npos = std::numeric_limits<size_type>::max();
 private: // members
-    static constexpr size_type _ARR_SIZE = 32;
+    static constexpr size_t _ARR_BYTES = 32;
+    static constexpr size_type _ARR_SIZE = _ARR_BYTES / sizeof(value_type);
     // data model:
-    // First byte = size if whole string is in buffer
-    // ELSE
-    //  - first byte = 0
-    //  - next 7 bytes: unused
+    // The last character of the buffer is a tag that tells the two modes apart.
+    // If the whole string is in the buffer (small mode):
+    //  - the characters start at the first byte
+    //  - the tag is max_in_buffer_size() - size, so it doubles as the null
+    //    terminator when the buffer is full
+    // ELSE (heap mode):
+    //  - first sizeof(pointer) bytes are the pointer to the heap objects
     //  - next 8 bytes = size
     //  - next 8 bytes = capacity
-    //  - next sizeof(pointer) bytes are the pointer to the heap objects
+    //  - the tag is heap_tag
+    // size() and data() only test the tag and never decode the heap fields of a
+    // small string, which compiles to a single well predicted compare.
+    static constexpr size_t POINTER_OFFSET = 0;
     static constexpr size_t SIZE_OFFSET = 8;
     static constexpr size_t CAPACITY_OFFSET = 8 + sizeof(size_type);
-    static constexpr size_t POINTER_OFFSET = 8 + 2 * sizeof(size_type);
-    static_assert(POINTER_OFFSET + sizeof(value_type*) <= _ARR_SIZE* sizeof(value_type), "array to small");
-    std::array<value_type, _ARR_SIZE> arr;
-    allocator_type alloc;
+    static_assert(sizeof(pointer) <= SIZE_OFFSET, "pointer to big");
+    static_assert(CAPACITY_OFFSET + sizeof(size_type) <= (_ARR_SIZE - 1) * sizeof(value_type), "array to small");
+    // the allocator is an (empty) base so it does not take space next to the buffer
+    struct rep_type : allocator_type {
+        explicit rep_type(const allocator_type &alloc) : allocator_type(alloc) {}
+        explicit rep_type(allocator_type && alloc) : allocator_type(std::move(alloc)) {}
+        std::array<value_type, _ARR_SIZE> arr;
+    };
+    rep_type rep;
 private: // Helpers
-    static constexpr unsigned char nullchar = std::numeric_limits<value_type>::max();
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    allocator_type &get_alloc() {
+        return rep;
+    }
+    const allocator_type &get_alloc() const {
+        return rep;
+    }
+
+    using tag_type = typename std::make_unsigned<value_type>::type;
+    static constexpr tag_type heap_tag = std::numeric_limits<tag_type>::max();
     static constexpr size_type max_in_buffer_size() {
-        return ((_ARR_SIZE - 1) / sizeof(value_type)) - 1;
+        return _ARR_SIZE - 1;
+    }
+
+    inline tag_type get_tag() const {
+        return tag_type(rep.arr[_ARR_SIZE - 1]);
+    }
+
+    inline void set_tag(tag_type tag) {
+        rep.arr[_ARR_SIZE - 1] = value_type(tag);
+    }
+
+    inline bool is_small() const {
+        return get_tag() != heap_tag;
+    }
+
+    inline void init_empty() {
+        rep.arr[0] = '\0';
+        set_tag(tag_type(max_in_buffer_size()));
     }
 
     inline void init(size_t count) {
         if (count <= max_in_buffer_size()) {
-            arr[0] = (unsigned char)(count);
-            (*end()) = '\0';
+            set_tag(tag_type(max_in_buffer_size() - count));
+            rep.arr[count] = '\0';
         } else {
-            arr[0] = nullchar;
+            set_tag(heap_tag);
             set_size(count);
-            auto ptr = alloc.allocate(count + 1);
+            auto ptr = get_alloc().allocate(count + 1);
             set_capacity(count);
             set_ptr(ptr);
             *(end()) = '\0';
         }
     }
 
+    // frees the heap buffer (if any) and leaves an empty small string
+    inline void release() {
+        if (!is_small()) {
+            get_alloc().deallocate(get_ptr(), get_capacity() + 1);
+            init_empty();
+        }
+    }
+
+    // takes over the buffer of str, both strings must use equal allocators
+    inline void steal(basic_string &str) {
+        release();
+        rep.arr = str.rep.arr;
+        str.init_empty();
+    }
+
+    inline void copy_assign_alloc(const basic_string &str, std::true_type /* propagate */) {
+        if (get_alloc() != str.get_alloc())
+            release();
+        get_alloc() = str.get_alloc();
+    }
+
+    inline void copy_assign_alloc(const basic_string &, std::false_type /* propagate */) {
+    }
+
+    inline void move_assign(basic_string &str, std::true_type /* propagate */) {
+        steal(str);
+        get_alloc() = std::move(str.get_alloc());
+    }
+
+    inline void move_assign(basic_string &str, std::false_type /* propagate */) {
+        // memory of a different allocator can not be taken over
+        if (get_alloc() == str.get_alloc())
+            steal(str);
+        else
+            assign(str.data(), str.size());
+    }
+
+    inline void swap_alloc(basic_string &other, std::true_type /* propagate */) {
+        using std::swap;
+        swap(get_alloc(), other.get_alloc());
+    }
+
+    inline void swap_alloc(basic_string &other, std::false_type /* propagate */) {
+        assert(get_alloc() == other.get_alloc());
+    }
+
     inline void set_capacity(size_type c) {
-        std::memcpy(arr.data() + CAPACITY_OFFSET, &c, sizeof(size_type));
+        std::memcpy(rep.arr.data() + CAPACITY_OFFSET / sizeof(value_type), &c, sizeof(size_type));
     }
 
     inline size_type get_capacity() const {
-        if (arr[0] != nullchar)
+        if (is_small())
             return max_in_buffer_size();
         size_type res;
-        std::memcpy(&res, arr.data() + CAPACITY_OFFSET, sizeof(res));
+        std::memcpy(&res, rep.arr.data() + CAPACITY_OFFSET / sizeof(value_type), sizeof(res));
         return res;
     }
 
     inline void set_size(size_type count) {
-        if (arr[0] != nullchar)
-            arr[0] = (unsigned char)(count);
+        if (is_small())
+            set_tag(tag_type(max_in_buffer_size() - count));
         else
-            std::memcpy(arr.data() + SIZE_OFFSET, &count, sizeof(size_type));
+            std::memcpy(rep.arr.data() + SIZE_OFFSET / sizeof(value_type), &count, sizeof(size_type));
     }
 
     inline size_type get_size() const {
-        if (arr[0] != nullchar)
-            return size_type(arr[0]);
         size_type res;
-        std::memcpy(&res, arr.data() + SIZE_OFFSET, sizeof(res));
-        return res;
+        std::memcpy(&res, rep.arr.data() + SIZE_OFFSET / sizeof(value_type), sizeof(res));
+        auto tag = get_tag();
+        return tag != heap_tag ? max_in_buffer_size() - tag : res;
     }
 
     inline void set_ptr(pointer ptr) {
-        std::memcpy(arr.data() + POINTER_OFFSET, &ptr, sizeof(ptr));
+        std::memcpy(rep.arr.data() + POINTER_OFFSET / sizeof(value_type), &ptr, sizeof(ptr));
 #ifndef NDEBUG
         auto nptr = get_ptr();
         assert(nptr == ptr);
@@ -123,13 +209,9 @@ private: // Helpers
     }
 
     inline pointer get_ptr() {
-        using val_ptr = value_type*;
-        if (arr[0] != nullchar) {
-            return pointer(reinterpret_cast<val_ptr>(arr.data() + 1));
-        }
         pointer res;
-        std::memcpy(&res, arr.data() + POINTER_OFFSET, sizeof(res));
-        return pointer(res);
+        std::memcpy(&res, rep.arr.data() + POINTER_OFFSET / sizeof(value_type), sizeof(res));
+        return is_small() ? pointer(rep.arr.data()) : res;
     }
     inline const_pointer get_ptr() const {
         return const_cast<basic_string<Char, Traits, Allocator>*>(this)->get_ptr();
@@ -140,12 +222,11 @@ public: // Helpers
     }
 public: // Constructors
     explicit basic_string(const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
-for (auto & c : arr) c = '\0';
-        arr[0] = 0;
+        : rep(alloc) {
+        init_empty();
     }
     basic_string(size_type count, Char ch, const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
+        : rep(alloc) {
         init(count);
         auto ptr = get_ptr();
         for (size_type i = 0; i < count; ++i) {
@@ -157,13 +238,10 @@ for (auto & c : arr) c = '\0';
                  size_type pos,
                  size_type count = npos,
                  const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
+        : rep(alloc) {
         auto osize = other.size();
         if (pos > osize)
             throw std::out_of_range("Trying to construct a string with pos >= size");
-        if (pos == osize) {
-for (auto & c : arr) c = '\0';
-        }
         auto cnt = osize - pos < count ? osize - pos : count;
         init(cnt);
         auto ptr = get_ptr();
@@ -172,14 +250,14 @@ for (auto & c : arr) c = '\0';
         ptr[cnt] = '\0';
     }
     basic_string(const_pointer s, size_type count, const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
+        : rep(alloc) {
         init(count);
         auto ptr = get_ptr();
         std::copy(s, s + count, ptr);
         ptr[count] = '\0';
     }
     basic_string(const_pointer s, const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
+        : rep(alloc) {
         size_type count = traits_type::length(s);
         init(count);
         auto ptr = get_ptr();
@@ -188,7 +266,7 @@ for (auto & c : arr) c = '\0';
     template< class InputIt >
     basic_string(InputIt first, InputIt last,
                  const Allocator &alloc = Allocator())
-        : alloc(alloc) {
+        : rep(alloc) {
         auto count = std::distance(first, last);
         init(count);
         auto ptr = get_ptr();
@@ -199,9 +277,10 @@ for (auto & c : arr) c = '\0';
         }
         *(ptr + count) = '\0';
     }
-    basic_string(const basic_string<Char, Traits, Allocator> &other) : alloc(other.alloc) {
-        if (other.arr[0] != nullchar) {
-            arr = other.arr;
+    basic_string(const basic_string<Char, Traits, Allocator> &other)
+        : rep(alloc_traits::select_on_container_copy_construction(other.get_alloc())) {
+        if (other.is_small()) {
+            rep.arr = other.rep.arr;
         } else {
             auto count = other.size();
             init(count);
@@ -209,9 +288,9 @@ for (auto & c : arr) c = '\0';
             get_ptr()[count] = '\0';
         }
     }
-    basic_string(const basic_string &other, const allocator_type &alloc) : alloc(alloc) {
-        if (other.arr[0] != nullchar) {
-            arr = other.arr;
+    basic_string(const basic_string &other, const allocator_type &alloc) : rep(alloc) {
+        if (other.is_small()) {
+            rep.arr = other.rep.arr;
         } else {
             auto count = other.size();
             init(count);
@@ -219,19 +298,20 @@ for (auto & c : arr) c = '\0';
             *(end()) = '\0';
         }
     }
-    basic_string(basic_string && other) noexcept(std::is_nothrow_move_assignable<allocator_type>::value) : arr(other.arr), alloc(std::move(other.alloc)) {
-for (auto & a : other.arr) {
-            a = '\0';
-        }
+    basic_string(basic_string && other) noexcept(std::is_nothrow_move_assignable<allocator_type>::value) : rep(std::move(other.get_alloc())) {
+        rep.arr = other.rep.arr;
+        other.init_empty();
     }
-    basic_string(basic_string && other, const allocator_type &alloc) noexcept(std::is_nothrow_assignable<allocator_type &, allocator_type>::value) : arr(other.arr), alloc(alloc) {
-for (auto & a : other.arr) {
-            a = '\0';
-        }
+    basic_string(basic_string && other, const allocator_type &alloc) : rep(alloc) {
+        init_empty();
+        if (get_alloc() == other.get_alloc())
+            steal(other);
+        else
+            assign(other.data(), other.size());
     }
     basic_string(std::initializer_list<value_type> linit,
                  const allocator_type &alloc = allocator_type())
-        : alloc(alloc) {
+        : rep(alloc) {
         init(linit.size());
         std::copy(linit.begin(), linit.end(), begin());
     }
@@ -242,28 +322,23 @@ for (auto & a : other.arr) {
     }
 
     ~basic_string() {
-        if (arr[0] == nullchar) {
-            alloc.deallocate(get_ptr(), capacity());
-            arr[0] = 0;
+        if (!is_small()) {
+            get_alloc().deallocate(get_ptr(), get_capacity() + 1);
         }
     }
 
     basic_string &operator=(const basic_string &str) {
+        if (this == &str) return *this;
+        copy_assign_alloc(str, typename alloc_traits::propagate_on_container_copy_assignment());
         reserve(str.size());
         std::copy(str.begin(), str.end(), begin());
         set_size(str.size());
         (*end()) = '\0';
         return *this;
     }
-    basic_string &operator=(basic_string && str) noexcept(std::is_nothrow_move_assignable<allocator_type>::value) {
-        if (arr[0] == nullchar) {
-            alloc.deallocate(get_ptr(), size());
-        }
-        alloc = std::move(str.alloc);
-        arr = str.arr;
-for (auto & a : str.arr) {
-            a = '\0';
-        }
+    basic_string &operator=(basic_string && str) noexcept(alloc_traits::propagate_on_container_move_assignment::value) {
+        if (this != &str)
+            move_assign(str, typename alloc_traits::propagate_on_container_move_assignment());
         return *this;
     }
     basic_string &operator=(const_pointer s) {
@@ -292,7 +367,6 @@ for (auto & a : str.arr) {
 
     // Compatibility with std::string
     basic_string &operator= (std::basic_string<Char, traits_type, allocator_type> &o) {
-        alloc = o.get_allocator();
         return assign(o.c_str(), o.size());
     }
 
@@ -307,7 +381,7 @@ for (auto & a : str.arr) {
         return *this;
     }
     basic_string &assign(const basic_string &str) {
-        (*this) = str;
+        return (*this) = str;
     }
     basic_string &assign(const basic_string &str,
                          size_type pos,
@@ -352,7 +426,7 @@ for (auto & a : str.arr) {
     }
 
     allocator_type get_allocator() const noexcept {
-        return alloc;
+        return get_alloc();
     }
 public: // iterators
     iterator begin() {
@@ -402,11 +476,9 @@ public: // Capacity
         return size() == 0;
     }
     size_type max_size() const {
-        return alloc.max_size() - 1;
+        return get_alloc().max_size() - 1;
     }
     size_type capacity() const {
-        if (arr[0] != nullchar)
-            return max_in_buffer_size();
         return get_capacity();
     }
     void shrink_to_fit() {
@@ -416,15 +488,15 @@ public: // Capacity
         if (c <= max_in_buffer_size()) return;
         if (s <= max_in_buffer_size()) {
             auto ptr = get_ptr();
-            arr[0] = (unsigned char)(s);
-            std::copy(ptr, ptr + s, arr.begin() + 1);
-            alloc.deallocate(ptr, c);
-            arr[1 + s] = '\0';
+            std::copy(ptr, ptr + s, rep.arr.begin());
+            get_alloc().deallocate(ptr, c + 1);
+            set_tag(tag_type(max_in_buffer_size() - s));
+            rep.arr[s] = '\0';
         } else {
-            auto nptr = alloc.allocate(s + 1);
+            auto nptr = get_alloc().allocate(s + 1);
             std::copy(begin(), end(), nptr);
             nptr[s] = '\0';
-            alloc.deallocate(get_ptr(), c);
+            get_alloc().deallocate(get_ptr(), c + 1);
             set_ptr(nptr);
             set_capacity(s);
         }
@@ -435,16 +507,16 @@ public: // Capacity
         // we at least double the capacity
         auto sz = size();
         new_cap = std::max(capacity() * 2, new_cap);
-        auto nptr = alloc.allocate(new_cap + 1);
+        auto nptr = get_alloc().allocate(new_cap + 1);
         if (!nptr)
             throw std::bad_alloc();
         auto ptr = get_ptr();
         std::copy(ptr, ptr + size() + 1, nptr);
-        if (arr[0] != nullchar) {
-            arr[0] = nullchar;
+        if (is_small()) {
+            set_tag(heap_tag);
             set_size(sz);
         } else {
-            alloc.deallocate(ptr, get_capacity());
+            get_alloc().deallocate(ptr, get_capacity() + 1);
         }
         set_capacity(new_cap);
         set_ptr(nptr);
@@ -563,15 +635,18 @@ public: // Operations
         return *this;
     }
     void push_back(value_type c) {
-        if (size() == capacity())
-            reserve(size() + 1);
-        (*this)[size()] = c;
-        set_size(size() + 1);
-        (*this)[size()] = '\0';
+        auto sz = size();
+        if (sz == capacity())
+            reserve(sz + 1);
+        auto ptr = get_ptr();
+        ptr[sz] = c;
+        set_size(sz + 1);
+        ptr[sz + 1] = '\0';
     }
     void pop_back() {
-        set_size(size() - 1);
-        (*this)[size()] = '\0';
+        auto sz = size() - 1;
+        set_size(sz);
+        get_ptr()[sz] = '\0';
     }
     template< class InputIt >
     basic_string &append(InputIt first, InputIt last) {
@@ -736,7 +811,7 @@ public: // Operations
     }
     basic_string substr(size_type pos = 0,
                         size_type count = npos) const {
-        return basic_string<value_type, traits_type, allocator_type>(*this, pos, count, alloc);
+        return basic_string<value_type, traits_type, allocator_type>(*this, pos, count, get_alloc());
     }
     size_type copy(value_type* dest,
                    size_type count,
@@ -757,12 +832,13 @@ public: // Operations
     void resize(size_type count, value_type ch) {
         auto old_size = size();
         reserve(count);
+        // the terminator may overlap the tag, so compute the range from old_size
         auto _begin = begin();
-        *(_begin + count) = '\0';
-        _begin = end();
+        auto _end = _begin + count;
+        *_end = '\0';
         set_size(count);
         if (old_size >= count) return;
-        auto _end = end();
+        _begin += old_size;
         while (_begin != _end) {
             *(_begin++) = ch;
         }
@@ -771,9 +847,10 @@ public: // Operations
         resize(count, value_type());
     }
     void swap(basic_string &other) {
-        auto tarr = arr;
-        arr = other.arr;
-        other.arr = tarr;
+        swap_alloc(other, typename alloc_traits::propagate_on_container_swap());
+        auto tarr = rep.arr;
+        rep.arr = other.rep.arr;
+        other.rep.arr = tarr;
     }
 public: // Element access
     reference operator[](size_type pos) {
@@ -813,24 +890,11 @@ public: // Element access
 public: // search
     size_type find(const_pointer s, size_type pos, size_type count) const {
         auto sz = size();
-        if (pos >= sz) return npos;
-        auto res = pos;
-        auto _begin = begin() + pos;
-        auto _end = end();
-        while (_begin + count != _end) {
-            auto iterA = s;
-            auto iterB = _begin;
-            decltype(count) matches = 0;
-            while (matches < count && *iterA == *iterB) {
-                ++iterA;
-                ++iterB;
-                ++matches;
-            }
-            if (matches == count) return res;
-            ++_begin;
-            ++res;
-        }
-        return npos;
+        if (pos > sz || count > sz - pos) return npos;
+        if (count == 0) return pos;
+        auto ptr = data();
+        auto res = impl::string_search<value_type, traits_type>::find(ptr + pos, sz - pos, s, count);
+        return res == nullptr ? npos : size_type(res - ptr);
     }
     size_type find(const_pointer s, size_type pos = 0) const {
         return find(s, pos, traits_type::length(s));
@@ -846,21 +910,12 @@ public: // search
     }
     size_type rfind(const_pointer s, size_type pos, size_type count) const {
         auto sz = size();
-        if (pos >= sz) pos = sz;
-        auto last = begin() - 1;
-        auto iter = begin() + pos;
         if (count > sz) return npos;
-        for (; iter != last; --iter) {
-            bool match = true;
-            auto iter2 = iter;
-            for (size_type i = 0; i < count; ++i) {
-                if (*iter2 != s[i]) {
-                    match = false;
-                    break;
-                }
-                ++iter2;
-            }
-            if (match) return std::distance(begin(), iter);
+        if (pos > sz - count) pos = sz - count;
+        auto ptr = data();
+        for (auto iter = ptr + pos; ; --iter) {
+            if (traits_type::compare(iter, s, count) == 0) return size_type(iter - ptr);
+            if (iter == ptr) break;
         }
         return npos;
     }
@@ -874,18 +929,11 @@ public: // search
         return rfind(&ch, pos, 1);
     }
     size_type find_first_of(const_pointer s, size_type pos, size_type count) const {
-        if (pos >= size()) return npos;
-        auto _begin = cbegin() + pos;
-        auto _end = end();
-        while (_begin != _end) {
-            for (size_type i = 0; i < count; ++i) {
-                if (*_begin == s[i]) {
-                    return std::distance(cbegin(), _begin);
-                }
-            }
-            ++_begin;
-        }
-        return npos;
+        auto sz = size();
+        if (pos >= sz || count == 0) return npos;
+        auto ptr = data();
+        auto res = impl::string_search<value_type, traits_type>::find_first_of(ptr + pos, sz - pos, s, count, true);
+        return res == nullptr ? npos : size_type(res - ptr);
     }
     size_type find_first_of(const basic_string &str, size_type pos = 0) const {
         return find_first_of(str.c_str(), pos, str.size());
@@ -894,81 +942,55 @@ public: // search
         return find_first_of(s, pos, traits_type::length(s));
     }
     size_type find_first_of(value_type ch, size_type pos = 0) const {
-        if (pos >= size()) return npos;
-        auto _begin = cbegin() + pos;
-        auto _end = end();
-        while (_begin != _end) {
-            if (*_begin == ch) return std::distance(cbegin(), _begin);
-            ++_begin;
-        }
-        return npos;
+        return find(ch, pos);
     }
     size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const {
-        if (pos >= size()) return npos;
-        auto _begin = cbegin() + pos;
-        auto _end = end();
-        while (_begin != _end) {
-            bool match = false;
-            for (size_type i = 0; i < count; ++i) {
-                if (*_begin == s[i]) {
-                    match = true;
-                    break;
-                }
-            }
-            if (!match) return std::distance(begin(), _begin);
-            ++_begin;
-        }
-        return npos;
+        auto sz = size();
+        if (pos >= sz) return npos;
+        auto ptr = data();
+        auto res = impl::string_search<value_type, traits_type>::find_first_of(ptr + pos, sz - pos, s, count, false);
+        return res == nullptr ? npos : size_type(res - ptr);
     }
     size_type find_first_not_of(const basic_string &str, size_type pos = 0) const {
         return find_first_not_of(str.c_str(), pos, str.size());
     }
     size_type find_first_not_of(const_pointer s, size_type pos = 0) const {
-        return find_first_not_of(s, pos, traits_type::length(pos));
+        return find_first_not_of(s, pos, traits_type::length(s));
     }
     size_type find_first_not_of(value_type ch, size_type pos = 0) const {
         if (pos >= size()) return npos;
         auto _begin = cbegin() + pos;
         auto _end = end();
         for (; _begin != _end; ++_begin) {
-            if (*_begin != ch)
+            if (!traits_type::eq(*_begin, ch))
                 return std::distance(begin(), _begin);
         }
         return npos;
     }
     size_type find_last_of(const_pointer s, size_type pos, size_type count) const {
-        auto iter = end() - 1 - (pos >= size() ? 0 : pos);
-        auto _end = begin() - 1;
-        for (; iter != _end; --iter) {
-            for (size_type i = 0; i < count; ++i) {
-                if (*iter == s[i]) return std::distance(begin(), iter);
-            }
-        }
-        return npos;
+        auto sz = size();
+        if (sz == 0 || count == 0) return npos;
+        auto n = (pos >= sz ? sz : pos + 1);
+        auto ptr = data();
+        auto res = impl::string_search<value_type, traits_type>::find_last_of(ptr, n, s, count, true);
+        return res == nullptr ? npos : size_type(res - ptr);
     }
     size_type find_last_of(const basic_string &str, size_type pos = npos) const {
         return find_last_of(str.c_str(), pos, str.size());
     }
-    size_type find_last_of(const_pointer* s, size_type pos = npos) const {
-        return find_last_of(s, pos, traits_type::length(pos));
+    size_type find_last_of(const_pointer s, size_type pos = npos) const {
+        return find_last_of(s, pos, traits_type::length(s));
     }
     size_type find_last_of(value_type ch, size_type pos = npos) const {
         return find_last_of(&ch, pos, 1);
     }
     size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const {
-        auto iter = end() - 1 - (pos >= size() ? 0 : pos);
-        auto _end = begin() - 1;
-        for (; iter != _end; --iter) {
-            bool match = false;
-            for (size_type i = 0; i < count; ++i) {
-                if (*iter == s[i]) {
-                    match = true;
-                    break;
-                }
-            }
-            if (!match) return std::distance(begin(), iter);
-        }
-        return npos;
+        auto sz = size();
+        if (sz == 0) return npos;
+        auto n = (pos >= sz ? sz : pos + 1);
+        auto ptr = data();
+        auto res = impl::string_search<value_type, traits_type>::find_last_of(ptr, n, s, count, false);
+        return res == nullptr ? npos : size_type(res - ptr);
     }
     size_type find_last_not_of(const basic_string &str, size_type pos = npos) const {
         return find_last_not_of(str.c_str(), pos, str.size());
@@ -1246,13 +1268,7 @@ using wstring = basic_string<wchar_t>;
 
 template<class CharT, class Traits, class Allocator>
 size_t hash_value(const crossbow::basic_string<CharT, Traits, Allocator> &str) {
-    constexpr size_t FNV_offset_basis = 14695981039346656037ul;
-    auto hash = FNV_offset_basis;
-    for (auto i = str.begin(); i != str.end(); ++i) {
-        hash *= FNV_offset_basis;
-        hash ^= size_t(*i);
-    }
-    return hash;
+    return static_cast<size_t>(hash_bytes(str.data(), str.size() * sizeof(CharT)));
 }
 
 template<class _CharT, class _Traits, class _Allocator>
@@ -0,0 +1,192 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace crossbow {
+namespace impl {
+
+/**
+ * @brief Search kernels of basic_string for arbitrary character traits
+ *
+ * All comparisons go through the traits so custom traits (e.g. case insensitive ones) keep working.
+ */
+template<class CharT, class Traits>
+struct string_search {
+    static const CharT* find(const CharT* haystack, size_t n, const CharT* needle, size_t m) {
+        auto last = haystack + (n - m);
+        for (auto p = haystack; p <= last; ++p) {
+            p = Traits::find(p, static_cast<size_t>(last - p) + 1, needle[0]);
+            if (p == nullptr) {
+                return nullptr;
+            }
+            if (Traits::compare(p + 1, needle + 1, m - 1) == 0) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    static const CharT* find_first_of(const CharT* str, size_t n, const CharT* set, size_t m, bool match) {
+        for (auto end = str + n; str != end; ++str) {
+            if ((Traits::find(set, m, *str) != nullptr) == match) {
+                return str;
+            }
+        }
+        return nullptr;
+    }
+
+    static const CharT* find_last_of(const CharT* str, size_t n, const CharT* set, size_t m, bool match) {
+        for (auto p = str + n; p != str;) {
+            --p;
+            if ((Traits::find(set, m, *p) != nullptr) == match) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Set of bytes represented as 256 bit bitmap
+ */
+class byte_set {
+public:
+    byte_set(const char* set, size_t m)
+            : mBits{0, 0, 0, 0} {
+        for (size_t i = 0; i < m; ++i) {
+            auto c = static_cast<unsigned char>(set[i]);
+            mBits[c >> 6] |= (uint64_t(1) << (c & 63));
+        }
+    }
+
+    bool contains(char c) const {
+        auto b = static_cast<unsigned char>(c);
+        return (mBits[b >> 6] >> (b & 63)) & 1;
+    }
+
+private:
+    uint64_t mBits[4];
+};
+
+/**
+ * @brief Vectorized kernels for plain char strings
+ *
+ * Substring search compares the first and the last character of the needle against 32 (AVX2) or 16 (SSE2) positions
+ * at once and only verifies candidates matching both. Needles longer than 16 characters are searched with memmem
+ * which uses the Two-Way algorithm with linear worst case complexity. Character set searches use a bitmap lookup.
+ */
+template<>
+struct string_search<char, std::char_traits<char>> {
+    static const char* find(const char* haystack, size_t n, const char* needle, size_t m) {
+        if (m == 1) {
+            return static_cast<const char*>(memchr(haystack, needle[0], n));
+        }
+#ifdef __GLIBC__
+        if (m > 16) {
+            return static_cast<const char*>(memmem(haystack, n, needle, m));
+        }
+#endif
+        size_t i = 0;
+#if defined(__AVX2__)
+        auto first = _mm256_set1_epi8(needle[0]);
+        auto last = _mm256_set1_epi8(needle[m - 1]);
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            auto blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+            auto blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + m - 1));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+                    _mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+            while (mask != 0) {
+                auto bit = static_cast<size_t>(__builtin_ctz(mask));
+                if (memcmp(haystack + i + bit + 1, needle + 1, m - 2) == 0) {
+                    return haystack + i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+#elif defined(__SSE2__)
+        auto first = _mm_set1_epi8(needle[0]);
+        auto last = _mm_set1_epi8(needle[m - 1]);
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            auto blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+            auto blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + m - 1));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+                    _mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+            while (mask != 0) {
+                auto bit = static_cast<size_t>(__builtin_ctz(mask));
+                if (memcmp(haystack + i + bit + 1, needle + 1, m - 2) == 0) {
+                    return haystack + i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
+        // Scalar search of the remaining positions
+        while (i + m <= n) {
+            auto p = static_cast<const char*>(memchr(haystack + i, needle[0], n - m - i + 1));
+            if (p == nullptr) {
+                return nullptr;
+            }
+            if (memcmp(p + 1, needle + 1, m - 1) == 0) {
+                return p;
+            }
+            i = static_cast<size_t>(p - haystack) + 1;
+        }
+        return nullptr;
+    }
+
+    static const char* find_first_of(const char* str, size_t n, const char* set, size_t m, bool match) {
+        if (m == 1 && match) {
+            return static_cast<const char*>(memchr(str, set[0], n));
+        }
+        byte_set bytes(set, m);
+        for (auto end = str + n; str != end; ++str) {
+            if (bytes.contains(*str) == match) {
+                return str;
+            }
+        }
+        return nullptr;
+    }
+
+    static const char* find_last_of(const char* str, size_t n, const char* set, size_t m, bool match) {
+        byte_set bytes(set, m);
+        for (auto p = str + n; p != str;) {
+            --p;
+            if (bytes.contains(*p) == match) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace impl
+} // namespace crossbow
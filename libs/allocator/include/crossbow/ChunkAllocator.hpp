@@ -21,10 +21,13 @@
  *     Lucas Braun <braunl@inf.ethz.ch>
  */
 #pragma once
+#include <crossbow/string.hpp>
+
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -95,6 +98,11 @@ public:
     typedef const T& const_reference;
     typedef T value_type;
 
+    // Memory always stays with the pool of the container it was allocated for
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type propagate_on_container_move_assignment;
+    typedef std::false_type propagate_on_container_swap;
+
     template <class U>
         struct rebind {
             typedef ChunkAllocator<U> other;
@@ -129,6 +137,23 @@ private:
     ChunkMemoryPool* m_pool;
 };
 
+/*!
+ * \brief String allocating from a ChunkMemoryPool
+ *
+ * Copies of an arena_string get the pool of the original, move and copy assignment keep the pool of the target. Moving
+ * between strings of different pools therefore copies the characters.
+ */
+using arena_string = basic_string<char, std::char_traits<char>, ChunkAllocator<char>>;
+
+template <class T>
+using arena_vector = std::vector<T, ChunkAllocator<T>>;
+
+template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+using arena_unordered_set = std::unordered_set<Key, Hash, KeyEqual, ChunkAllocator<Key>>;
+
+template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+using arena_unordered_map = std::unordered_map<Key, T, Hash, KeyEqual, ChunkAllocator<std::pair<const Key, T>>>;
+
 template <class T>
 ChunkAllocator<T>::ChunkAllocator(ChunkMemoryPool* pool)
     : m_pool{pool} {
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <crossbow/byte_buffer.hpp>
+#include <crossbow/chained_buffer.hpp>
 #include <crossbow/infinio/ErrorCode.hpp>
 #include <crossbow/infinio/InfinibandBuffer.hpp>
 #include <crossbow/infinio/InfinibandService.hpp>
@@ -109,6 +110,20 @@ protected:
     template <typename Fun>
     void writeMessage(MessageId messageId, uint32_t messageType, uint32_t messageLength, Fun fun, std::error_code& ec);
 
+    /**
+     * @brief Writes a message assembled in a chained buffer
+     *
+     * The segments are copied into the batched send buffer, the caller does not have to know the message length in
+     * advance.
+     */
+    void writeMessage(MessageId messageId, uint32_t messageType, const crossbow::chained_buffer& message,
+            std::error_code& ec) {
+        writeMessage(messageId, messageType, static_cast<uint32_t>(message.size()),
+                [&message] (crossbow::buffer_writer& writer, std::error_code& /* ec */) {
+            message.copyTo(writer);
+        }, ec);
+    }
+
     void handleSocketError(const std::error_code& ec);
 
     InfinibandSocket mSocket;
@@ -404,7 +419,7 @@ void BatchingMessageSocket<Handler>::scheduleFlush() {
 
 template <typename Handler>
 void BatchingMessageSocket<Handler>::handleSocketError(const std::error_code& ec) {
-    LOG_ERROR("Error during socket operation [error = %1% %2%]", ec, ec.message());
+    LOG_ERROR_EVERY_MS(1000, "Error during socket operation [error = %1% %2%]", ec, ec.message());
 
     // TODO Try to recover from errors
 
@@ -25,11 +25,15 @@
 #include <crossbow/non_copyable.hpp>
 #include <crossbow/singleconsumerqueue.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <queue>
 #include <system_error>
+#include <thread>
 #include <vector>
 
 namespace crossbow {
@@ -60,11 +64,219 @@ public:
     virtual void wakeup() = 0;
 };
 
+/**
+ * @brief Configuration of the idle strategy of the EventProcessor
+ *
+ * While no poller has any events the event loop passes through three phases:
+ *
+ * 1. Spin: Poll with an exponentially growing number of pause instructions (up to maxPauses) between rounds until the
+ *    spin budget (a time between minSpinTime and maxSpinTime) elapsed or maxSpinRounds rounds were polled
+ * 2. Yield: Poll with a sched_yield between rounds for yieldRounds rounds
+ * 3. Sleep: Go to epoll sleep until an event on any fd is triggered
+ *
+ * The spin budget is learned from the gaps between events: It doubles whenever an event arrived at most growWindow after
+ * the spin phase ended (spinning a bit longer would have caught it) and halves whenever the gap was longer (spinning was
+ * wasted). Events arriving within the spin phase leave the budget unchanged.
+ */
+struct IdleConfig {
+    explicit IdleConfig(uint64_t pollCycles)
+            : maxSpinRounds(pollCycles),
+              maxSpinTime(std::chrono::microseconds(500)),
+              minSpinTime(std::chrono::microseconds(10)),
+              maxPauses(8),
+              yieldRounds(64),
+              growWindow(std::chrono::microseconds(200)),
+              sleepTimeout(std::chrono::milliseconds(100)) {
+    }
+
+    /// Maximum number of idle rounds to spin
+    uint64_t maxSpinRounds;
+
+    /// Maximum time to spin (also the initial spin budget)
+    std::chrono::nanoseconds maxSpinTime;
+
+    /// Minimum time to spin
+    std::chrono::nanoseconds minSpinTime;
+
+    /// Maximum number of pause instructions between two idle rounds
+    uint32_t maxPauses;
+
+    /// Number of idle rounds yielding the CPU before going to sleep
+    uint32_t yieldRounds;
+
+    /// Events arriving within this time after the spin phase grow the spin budget, later ones shrink it
+    std::chrono::nanoseconds growWindow;
+
+    /// Maximum time to wait in a single epoll call (bounds the time to notice a shutdown)
+    std::chrono::milliseconds sleepTimeout;
+};
+
+/**
+ * @brief Decides what the event loop does after a poll round without events (see IdleConfig)
+ *
+ * The policy does not read the clock itself, the current time (in nanoseconds) is passed in by the event loop.
+ */
+class IdlePolicy {
+public:
+    enum class Action {
+        SPIN,
+        YIELD,
+        SLEEP
+    };
+
+    explicit IdlePolicy(const IdleConfig& config)
+            : mMaxSpinRounds(config.maxSpinRounds),
+              mMaxSpinTime(config.maxSpinTime.count()),
+              mMinSpinTime(std::min(config.minSpinTime.count(), mMaxSpinTime)),
+              mMaxPauses(std::max(config.maxPauses, 1u)),
+              mYieldRounds(config.yieldRounds),
+              mGrowWindow(config.growWindow.count()),
+              mBudget(mMaxSpinTime),
+              mIdle(false),
+              mIdleStart(0),
+              mSpinEnd(0),
+              mRounds(0),
+              mYields(0),
+              mPauses(1),
+              mSpinNanos(0) {
+    }
+
+    /**
+     * @brief Whether the last poll round had no events
+     */
+    bool idling() const {
+        return mIdle;
+    }
+
+    /**
+     * @brief Invoked after a poll round without events
+     */
+    Action idle(int64_t now) {
+        if (!mIdle) {
+            mIdle = true;
+            mIdleStart = now;
+            mSpinEnd = 0;
+            mRounds = 0;
+            mYields = 0;
+            mPauses = 1;
+        }
+        if (mSpinEnd == 0) {
+            if (now - mIdleStart < mBudget && mRounds < mMaxSpinRounds) {
+                if (mRounds != 0) {
+                    mPauses = std::min(mPauses * 2, mMaxPauses);
+                }
+                ++mRounds;
+                return Action::SPIN;
+            }
+            mSpinEnd = now;
+            mSpinNanos += static_cast<uint64_t>(now - mIdleStart);
+        }
+        if (mYields < mYieldRounds) {
+            ++mYields;
+            return Action::YIELD;
+        }
+        return Action::SLEEP;
+    }
+
+    /**
+     * @brief Invoked after a poll round with events following an idle period
+     */
+    void busy(int64_t now) {
+        if (!mIdle) {
+            return;
+        }
+        mIdle = false;
+        if (mSpinEnd == 0) {
+            // Caught while spinning
+            mSpinNanos += static_cast<uint64_t>(now - mIdleStart);
+            return;
+        }
+        if (now - mSpinEnd <= mGrowWindow) {
+            mBudget = std::min(mBudget * 2, mMaxSpinTime);
+        } else {
+            mBudget = std::max(mBudget / 2, mMinSpinTime);
+        }
+    }
+
+    /**
+     * @brief Number of pause instructions to execute before the next spin round
+     */
+    uint32_t pauses() const {
+        return mPauses;
+    }
+
+    /**
+     * @brief The current spin budget in nanoseconds
+     */
+    int64_t budget() const {
+        return mBudget;
+    }
+
+    /**
+     * @brief Total time spent spinning without events
+     */
+    uint64_t spinNanos() const {
+        return mSpinNanos;
+    }
+
+private:
+    uint64_t mMaxSpinRounds;
+    int64_t mMaxSpinTime;
+    int64_t mMinSpinTime;
+    uint32_t mMaxPauses;
+    uint32_t mYieldRounds;
+    int64_t mGrowWindow;
+
+    int64_t mBudget;
+    bool mIdle;
+    int64_t mIdleStart;
+    int64_t mSpinEnd;
+    uint64_t mRounds;
+    uint32_t mYields;
+    uint32_t mPauses;
+    uint64_t mSpinNanos;
+};
+
+/**
+ * @brief Statistics of the event loop
+ */
+struct EventProcessorStats {
+    /// Number of poll rounds in which at least one poller had events
+    uint64_t busyRounds;
+
+    /// Number of poll rounds without any events (spinning and yielding)
+    uint64_t idleRounds;
+
+    /// Total time spent spinning without events (CPU time burned while idle)
+    uint64_t spinNanos;
+
+    /// Number of times the CPU was yielded
+    uint64_t yields;
+
+    /// Number of times the event loop went to epoll sleep
+    uint64_t sleeps;
+
+    /// Total time spent in epoll sleep
+    uint64_t sleepNanos;
+
+    /// Number of wake ups from sleep triggered by a TaskQueue
+    uint64_t wakeups;
+
+    /// Total time between a TaskQueue signaling the sleeping event loop and the event loop waking up
+    uint64_t wakeupLatencyNanos;
+
+    /// Maximum time between a TaskQueue signaling the sleeping event loop and the event loop waking up
+    uint64_t maxWakeupLatencyNanos;
+
+    /// The current spin budget in nanoseconds
+    uint64_t spinBudgetNanos;
+};
+
 /**
  * @brief Class providing a simple poll based event loop
  *
  * After a number of unsuccessful poll rounds the EventProcessor will go into epoll sleep and wake up whenever an event
- * on any fd is triggered.
+ * on any fd is triggered. See IdleConfig for the details of the idle strategy.
  */
 class EventProcessor : private crossbow::non_copyable, crossbow::non_movable {
 public:
@@ -77,6 +289,8 @@ public:
      */
     EventProcessor(uint64_t pollCycles);
 
+    EventProcessor(const IdleConfig& config);
+
     /**
      * @brief Shuts down the event processor
      */
@@ -114,14 +328,75 @@ public:
      */
     void start();
 
+    /**
+     * @brief Snapshot of the event loop statistics
+     *
+     * Can be called from any thread.
+     */
+    EventProcessorStats stats() const;
+
+    /**
+     * @brief Records the latency between signaling the sleeping event loop and the event loop waking up
+     *
+     * Can only be called from within the poll thread.
+     */
+    void recordWakeupLatency(uint64_t nanos);
+
 private:
+    /**
+     * @brief Counters of the event loop
+     *
+     * Only written by the poll thread, the relaxed load and store compile to plain memory accesses.
+     */
+    struct Counters {
+        Counters()
+                : busyRounds(0),
+                  idleRounds(0),
+                  spinNanos(0),
+                  yields(0),
+                  sleeps(0),
+                  sleepNanos(0),
+                  wakeups(0),
+                  wakeupLatencyNanos(0),
+                  maxWakeupLatencyNanos(0),
+                  spinBudgetNanos(0) {
+        }
+
+        std::atomic<uint64_t> busyRounds;
+        std::atomic<uint64_t> idleRounds;
+        std::atomic<uint64_t> spinNanos;
+        std::atomic<uint64_t> yields;
+        std::atomic<uint64_t> sleeps;
+        std::atomic<uint64_t> sleepNanos;
+        std::atomic<uint64_t> wakeups;
+        std::atomic<uint64_t> wakeupLatencyNanos;
+        std::atomic<uint64_t> maxWakeupLatencyNanos;
+        std::atomic<uint64_t> spinBudgetNanos;
+    };
+
     /**
      * @brief Execute the event loop
      */
     void doPoll();
 
-    /// Number of iterations without action to poll until going to epoll sleep
-    uint64_t mPollCycles;
+    /**
+     * @brief Poll all pollers once
+     *
+     * @return Whether any poller processed events
+     */
+    bool pollAll();
+
+    /**
+     * @brief Publishes the counters maintained by the idle policy
+     */
+    void publishIdleCounters();
+
+    IdleConfig mConfig;
+
+    /// Idle strategy of the event loop (only accessed from the poll thread)
+    IdlePolicy mIdle;
+
+    Counters mCounters;
 
     /// File descriptor for epoll
     int mEpoll;
@@ -173,6 +448,9 @@ private:
 
     /// Whether the event processor is sleeping
     std::atomic<bool> mSleeping;
+
+    /// Time (in nanoseconds of the steady clock) the sleeping event processor was first signaled
+    std::atomic<int64_t> mSignalTime;
 };
 
 /**
@@ -22,6 +22,7 @@
  */
 #pragma once
 
+#include <crossbow/chained_buffer.hpp>
 #include <crossbow/non_copyable.hpp>
 
 #include <cstddef>
@@ -354,6 +355,14 @@ public:
 
     void add(const InfinibandBuffer& buffer, size_t offset, uint32_t length);
 
+    /**
+     * @brief Adds all non empty segments of the chained buffer without copying
+     *
+     * The segments must be located in the memory region, i.e. the pool of the chained buffer has to be backed by the
+     * registered memory.
+     */
+    void add(const LocalMemoryRegion& region, const crossbow::chained_buffer& buffer);
+
     void* data(size_t index) {
         return const_cast<void*>(const_cast<const ScatterGatherBuffer*>(this)->data(index));
     }
@@ -74,7 +74,9 @@ public:
     uint32_t completionQueueLength;
 
     /**
-     * @brief Number of iterations without action to poll until going to epoll sleep
+     * @brief Maximum number of iterations without action to spin before yielding and going to epoll sleep
+     *
+     * The spin phase is additionally bounded by a time budget learned from the observed event gaps (see IdleConfig).
      */
     uint64_t pollCycles;
 
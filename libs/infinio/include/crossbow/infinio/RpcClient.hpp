@@ -261,7 +261,12 @@ void RpcResponseResult<Handler, Result>::onResponse(uint32_t messageType, crossb
     LOG_ASSERT(mState == RpcResponseState::UNSET, "Result is already set");
 
     if (messageType == std::numeric_limits<uint32_t>::max()) {
-        setError(message.read<uint64_t>(), Handler::errorCategory());
+        uint64_t errorCode;
+        if (!message.tryRead(errorCode)) {
+            setError(error::invalid_message);
+            return;
+        }
+        setError(errorCode, Handler::errorCategory());
         return;
     }
 
@@ -360,7 +365,12 @@ void RpcResponseResult<Handler, void>::onResponse(uint32_t messageType, crossbow
     LOG_ASSERT(!done(), "Response is already done");
 
     if (messageType == std::numeric_limits<uint32_t>::max()) {
-        onAbort(std::error_code(message.read<uint64_t>(), Handler::errorCategory()));
+        uint64_t errorCode;
+        if (!message.tryRead(errorCode)) {
+            onAbort(error::invalid_message);
+            return;
+        }
+        onAbort(std::error_code(errorCode, Handler::errorCategory()));
         return;
     }
 
@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/infinio/ErrorCode.hpp>
+#include <crossbow/infinio/InfinibandBuffer.hpp>
+
+#include <crossbow/byte_buffer.hpp>
+#include <crossbow/serializer/BufferSerializer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace crossbow {
+namespace infinio {
+
+/**
+ * @brief Segments for the crossbow::buffer_serializer adding all serialized buffers to a ScatterGatherBuffer
+ *
+ * New buffers are acquired through the Acquire functor (returning an InfinibandBuffer, e.g. a wrapper around
+ * InfinibandSocket::acquireSendBuffer). The acquired buffers are owned by the segments object and have to be released
+ * by the user after the scatter gather write completed.
+ */
+template <typename Acquire>
+class ScatterGatherSegments {
+public:
+    ScatterGatherSegments(ScatterGatherBuffer& buffer, Acquire acquire)
+            : mBuffer(buffer),
+              mAcquire(std::move(acquire)) {
+    }
+
+    crossbow::buffer_writer acquire() {
+        auto buffer = mAcquire();
+        if (!buffer.valid()) {
+            return crossbow::buffer_writer(static_cast<char*>(nullptr), 0);
+        }
+        mBuffers.emplace_back(std::move(buffer));
+        auto& current = mBuffers.back();
+        return crossbow::buffer_writer(current.data(), current.length());
+    }
+
+    void append(const char* data, size_t length) {
+        if (length == 0) {
+            return;
+        }
+        auto& current = mBuffers.back();
+        auto offset = static_cast<size_t>(data - reinterpret_cast<const char*>(current.data()));
+        mBuffer.add(current, offset, static_cast<uint32_t>(length));
+    }
+
+    /**
+     * @brief The buffers acquired during serialization
+     */
+    std::vector<InfinibandBuffer>& buffers() {
+        return mBuffers;
+    }
+
+private:
+    ScatterGatherBuffer& mBuffer;
+    Acquire mAcquire;
+    std::vector<InfinibandBuffer> mBuffers;
+};
+
+/**
+ * @brief Serializes the object into Infiniband buffers acquired from the segments and adds them to the scatter gather
+ * buffer
+ *
+ * The object is split across buffers at element boundaries.
+ *
+ * @param segments Segments the buffers are acquired from
+ * @param obj The object to serialize
+ * @param ec Error in case not enough buffers could be acquired
+ */
+template <typename Acquire, typename T>
+void serialize(ScatterGatherSegments<Acquire>& segments, const T& obj, std::error_code& ec) {
+    auto writer = segments.acquire();
+    if (writer.end() == writer.data()) {
+        ec = error::invalid_buffer;
+        return;
+    }
+
+    try {
+        crossbow::serialize(writer, obj, segments);
+    } catch (std::length_error&) {
+        ec = error::invalid_buffer;
+    }
+}
+
+} // namespace infinio
+} // namespace crossbow
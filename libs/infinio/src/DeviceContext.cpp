@@ -361,7 +361,7 @@ void CompletionContext::wakeup() {
 }
 
 void CompletionContext::processWorkComplete(struct ibv_wc* wc) {
-    LOG_TRACE("Processing WC with ID %1% on queue %2% with status %3% %4%", wc->wr_id, wc->qp_num, wc->status,
+    BINLOG_TRACE("Processing WC with ID %1% on queue %2% with status %3% %4%", wc->wr_id, wc->qp_num, wc->status,
             ibv_wc_status_str(wc->status));
 
     WorkRequestId workId(wc->wr_id);
@@ -25,17 +25,49 @@
 #include <crossbow/logger.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 
+#include <sched.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 
 namespace crossbow {
 namespace infinio {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void cpuRelax(uint32_t pauses) {
+    for (uint32_t i = 0; i < pauses; ++i) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+}
+
+} // anonymous namespace
 
 EventProcessor::EventProcessor(uint64_t pollCycles)
-        : mPollCycles(pollCycles)
+        : EventProcessor(IdleConfig(pollCycles)) {
+}
+
+EventProcessor::EventProcessor(const IdleConfig& config)
+        : mConfig(config)
+        , mIdle(config)
         , mShutdown(false) {
+    publishIdleCounters();
+
     LOG_TRACE("Creating epoll file descriptor");
     mEpoll = epoll_create1(EPOLL_CLOEXEC);
     if (mEpoll == -1) {
@@ -44,18 +76,22 @@ EventProcessor::EventProcessor(uint64_t pollCycles)
 }
 
 EventProcessor::~EventProcessor() {
-    // TODO We have to join the poll thread
+    // The poll thread notices the shutdown at the latest after the epoll timeout
     // We are not allowed to call join in the same thread as the poll loop is
-
     mShutdown.store(true);
+    if (mPollThread.joinable()) {
+        if (mPollThread.get_id() == std::this_thread::get_id()) {
+            mPollThread.detach();
+        } else {
+            mPollThread.join();
+        }
+    }
+
     LOG_TRACE("Destroying epoll file descriptor");
     if (close(mEpoll)) {
         std::error_code ec(errno, std::generic_category());
         LOG_ERROR("Failed to close the epoll descriptor [error = %1% %2%]", ec, ec.message());
     }
-    if (mPollThread.joinable()) {
-        mPollThread.join();
-    }
 }
 
 void EventProcessor::registerPoll(int fd, EventPoll* poll) {
@@ -97,13 +133,69 @@ void EventProcessor::start() {
     });
 }
 
+EventProcessorStats EventProcessor::stats() const {
+    EventProcessorStats stats;
+    stats.busyRounds = mCounters.busyRounds.load(std::memory_order_relaxed);
+    stats.idleRounds = mCounters.idleRounds.load(std::memory_order_relaxed);
+    stats.spinNanos = mCounters.spinNanos.load(std::memory_order_relaxed);
+    stats.yields = mCounters.yields.load(std::memory_order_relaxed);
+    stats.sleeps = mCounters.sleeps.load(std::memory_order_relaxed);
+    stats.sleepNanos = mCounters.sleepNanos.load(std::memory_order_relaxed);
+    stats.wakeups = mCounters.wakeups.load(std::memory_order_relaxed);
+    stats.wakeupLatencyNanos = mCounters.wakeupLatencyNanos.load(std::memory_order_relaxed);
+    stats.maxWakeupLatencyNanos = mCounters.maxWakeupLatencyNanos.load(std::memory_order_relaxed);
+    stats.spinBudgetNanos = mCounters.spinBudgetNanos.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventProcessor::recordWakeupLatency(uint64_t nanos) {
+    increment(mCounters.wakeups);
+    increment(mCounters.wakeupLatencyNanos, nanos);
+    if (nanos > mCounters.maxWakeupLatencyNanos.load(std::memory_order_relaxed)) {
+        mCounters.maxWakeupLatencyNanos.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+bool EventProcessor::pollAll() {
+    bool result = false;
+    for (auto poller : mPoller) {
+        if (poller->poll()) {
+            result = true;
+        }
+    }
+    increment(result ? mCounters.busyRounds : mCounters.idleRounds);
+    return result;
+}
+
+void EventProcessor::publishIdleCounters() {
+    mCounters.spinNanos.store(mIdle.spinNanos(), std::memory_order_relaxed);
+    mCounters.spinBudgetNanos.store(static_cast<uint64_t>(mIdle.budget()), std::memory_order_relaxed);
+}
+
 void EventProcessor::doPoll() {
-    for (decltype(mPollCycles) i = 0; i < mPollCycles; ++i) {
-        for (auto poller : mPoller) {
-            if (poller->poll()) {
-                i = 0;
+    // Spin with exponential back-off and then yield until the idle policy decides to sleep
+    while (!mShutdown.load(std::memory_order_relaxed)) {
+        if (pollAll()) {
+            if (mIdle.idling()) {
+                mIdle.busy(nowNanos());
+                publishIdleCounters();
             }
+            continue;
         }
+
+        auto action = mIdle.idle(nowNanos());
+        if (action == IdlePolicy::Action::SPIN) {
+            cpuRelax(mIdle.pauses());
+        } else if (action == IdlePolicy::Action::YIELD) {
+            sched_yield();
+            increment(mCounters.yields);
+        } else {
+            break;
+        }
+    }
+    publishIdleCounters();
+    if (mShutdown.load()) {
+        return;
     }
 
     for (auto poller : mPoller) {
@@ -111,13 +203,26 @@ void EventProcessor::doPoll() {
     }
 
     LOG_TRACE("Going to epoll sleep");
-    struct epoll_event events[mPoller.size()];
-    auto num = epoll_wait(mEpoll, events, 10, -1);
+    auto timeout = static_cast<int>(mConfig.sleepTimeout.count());
+    std::array<struct epoll_event, 16> events;
+    auto begin = Clock::now();
+    int num;
+    do {
+        num = epoll_wait(mEpoll, events.data(), static_cast<int>(events.size()), timeout);
+    } while (num == 0 && !mShutdown.load());
+    auto slept = Clock::now() - begin;
     LOG_TRACE("Wake up from epoll sleep with %1% events", num);
 
+    increment(mCounters.sleeps);
+    increment(mCounters.sleepNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(slept).count());
+
+    if (num == -1 && errno != EINTR) {
+        LOG_ERROR_EVERY_MS(1000, "Error while waiting for epoll events [errno = %1%]", errno);
+    }
+
     for (int i = 0; i < num; ++i) {
         if ((events[i].events & EPOLLERR) || (events[i].events & EPOLLHUP) || (!(events[i].events & EPOLLIN))) {
-            LOG_ERROR("Error has occured on fd");
+            LOG_ERROR_EVERY_MS(1000, "Error has occured on fd");
             continue;
         }
 
@@ -128,7 +233,8 @@ void EventProcessor::doPoll() {
 
 TaskQueue::TaskQueue(EventProcessor& processor)
         : mProcessor(processor),
-          mSleeping(false) {
+          mSleeping(false),
+          mSignalTime(0) {
     mInterrupt = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     if (mInterrupt == -1) {
         throw std::system_error(errno, std::generic_category());
@@ -153,6 +259,9 @@ TaskQueue::~TaskQueue() {
 void TaskQueue::execute(std::function<void()> fun) {
     mTaskQueue.write(std::move(fun));
     if (mSleeping.load()) {
+        int64_t expected = 0;
+        mSignalTime.compare_exchange_strong(expected, nowNanos());
+
         uint64_t counter = 0x1u;
         write(mInterrupt, &counter, sizeof(uint64_t));
     }
@@ -172,6 +281,7 @@ bool TaskQueue::poll() {
 }
 
 void TaskQueue::prepareSleep() {
+    mSignalTime.store(0);
     auto wasSleeping = mSleeping.exchange(true);
     if (wasSleeping) {
         return;
@@ -186,6 +296,11 @@ void TaskQueue::wakeup() {
 
     uint64_t counter = 0;
     read(mInterrupt, &counter, sizeof(uint64_t));
+
+    auto signalTime = mSignalTime.exchange(0);
+    if (signalTime != 0) {
+        mProcessor.recordWakeupLatency(static_cast<uint64_t>(std::max<int64_t>(nowNanos() - signalTime, 0)));
+    }
 }
 
 LocalTaskQueue::LocalTaskQueue(EventProcessor& processor)
@@ -55,6 +55,14 @@ void ScatterGatherBuffer::add(const InfinibandBuffer& buffer, size_t offset, uin
     mLength += length;
 }
 
+void ScatterGatherBuffer::add(const LocalMemoryRegion& region, const crossbow::chained_buffer& buffer) {
+    buffer.forEachSegment([this, &region] (const char* data, size_t length) {
+        if (length != 0) {
+            add(region, data, static_cast<uint32_t>(length));
+        }
+    });
+}
+
 LocalMemoryRegion::LocalMemoryRegion(const ProtectionDomain& domain, void* data, size_t length, int access)
         : mDataRegion(ibv_reg_mr(domain.get(), data, length, access)) {
     if (mDataRegion == nullptr) {
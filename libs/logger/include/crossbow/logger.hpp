@@ -23,10 +23,20 @@
 #pragma once
 
 #include <iostream>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <mutex>
-#include <boost/format.hpp>
+#include <crossbow/logger/binary_sink.hpp>
+#include <crossbow/logger/format.hpp>
+#include <crossbow/logger/rate_limit.hpp>
 #include <crossbow/singleton.hpp>
 #include <crossbow/string.hpp>
 
@@ -45,30 +55,60 @@ enum class LogLevel
 
 LogLevel logLevelFromString(const crossbow::string& s);
 
-template<class... Args>
-struct LogFormatter;
+const char* logLevelToString(LogLevel level);
 
-template<class Head, class... Tail>
-struct LogFormatter<Head, Tail...> {
-    LogFormatter<Tail...> base;
+/**
+ * @brief Behaviour of the asynchronous logger when the ring buffer of a thread is full
+ */
+enum class OverflowPolicy
+    : unsigned char {
+    /// Discard the record (the number of dropped records is logged later)
+    DROP = 0,
 
-    void format(boost::format& f, Head h, Tail&&... tail) const {
-        f % h;
-        base.format(f, std::forward<Tail>(tail)...);
-    }
+    /// Wait until the background thread made room for the record
+    BLOCK
 };
 
-template<>
-struct LogFormatter<> {
-    void format(boost::format&) const {
-        return;
+namespace impl {
+
+/**
+ * @brief Current log level
+ *
+ * Kept outside of the logger singleton so that the logging macros can reject disabled levels without accessing the
+ * singleton.
+ */
+extern std::atomic<LogLevel> gLogLevel;
+
+} // namespace impl
+
+/**
+ * @brief Checks if messages with the given level are logged
+ */
+inline bool isEnabled(LogLevel level) {
+    return level >= impl::gLogLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Log level setting of the logger configuration
+ *
+ * Assignments and reads are forwarded to the global log level.
+ */
+class LogLevelSetting {
+public:
+    LogLevelSetting& operator=(LogLevel level) {
+        impl::gLogLevel.store(level, std::memory_order_relaxed);
+        return *this;
+    }
+
+    operator LogLevel() const {
+        return impl::gLogLevel.load(std::memory_order_relaxed);
     }
 };
 
 struct LoggerConfig {
     using DestructFunction = std::function<void()>;
     std::vector<DestructFunction> destructFunctions;
-    LogLevel level;
+    LogLevelSetting level;
     std::ostream* traceOut = &std::cout;
     std::ostream* debugOut = &std::cout;
     std::ostream* infoOut = &std::cout;
@@ -77,66 +117,465 @@ struct LoggerConfig {
     std::ostream* fatalOut = &std::cerr;
 };
 
+namespace impl {
+
+template<class T>
+struct record_arg {
+    using type = typename std::decay<T>::type;
+};
+
+// C strings are copied as the pointer might be invalid by the time the record is formatted
+template<>
+struct record_arg<char*> {
+    using type = std::string;
+};
+
+template<>
+struct record_arg<const char*> {
+    using type = std::string;
+};
+
+template<class T>
+using record_arg_t = typename record_arg<typename std::decay<T>::type>::type;
+
+/**
+ * @brief Whether all arguments can be copied or moved into a log record
+ *
+ * Records with other arguments are formatted by the logging thread.
+ */
+template<class... Args>
+struct is_recordable : std::true_type {
+};
+
+template<class Head, class... Tail>
+struct is_recordable<Head, Tail...> : std::integral_constant<bool,
+        std::is_constructible<record_arg_t<Head>, Head&&>::value && is_recordable<Tail...>::value> {
+};
+
+// Format string literals are stored as pointer, all other format strings are copied
+template<class Format>
+struct record_format {
+    using type = crossbow::string;
+};
+
+template<size_t N>
+struct record_format<char[N]> {
+    using type = const char*;
+};
+
+template<class Format>
+using record_format_t = typename record_format<Format>::type;
+
+inline const char* formatString(const char* str) {
+    return str;
+}
+
+inline const char* formatString(const crossbow::string& str) {
+    return str.c_str();
+}
+
+inline const char* formatString(const std::string& str) {
+    return str.c_str();
+}
+
+template<size_t... Indices>
+struct index_sequence {
+};
+
+template<size_t N, size_t... Indices>
+struct make_index_sequence : make_index_sequence<N - 1, N - 1, Indices...> {
+};
+
+template<size_t... Indices>
+struct make_index_sequence<0, Indices...> {
+    using type = index_sequence<Indices...>;
+};
+
+template<class Tuple, size_t... Indices>
+void formatTuple(std::string& out, const char* str, const Tuple& args, index_sequence<Indices...>) {
+    format(out, str, std::get<Indices>(args)...);
+}
+
+/**
+ * @brief Appends the source location suffix of a log line
+ */
+void appendLocation(std::string& out, const char* file, unsigned line, const char* function);
+
+/**
+ * @brief Appends the number of messages suppressed by a rate limited logging statement
+ */
+inline void appendSuppressed(std::string& out, uint64_t suppressed) {
+    if (suppressed == 0) {
+        return;
+    }
+    out.append(" [");
+    appendUnsigned(out, suppressed);
+    out.append(" similar messages suppressed]");
+}
+
+/**
+ * @brief Log record written into the ring of the logging thread and formatted by the background thread
+ */
+template<class Format, class... Args>
+struct LogRecord {
+    template<class... T>
+    LogRecord(const char* f, unsigned l, const char* fun, uint64_t s, const Format& fmt, T&&... a)
+        : file(f)
+        , line(l)
+        , function(fun)
+        , suppressed(s)
+        , format(fmt)
+        , args(std::forward<T>(a)...)
+    {}
+
+    const char* file;
+    unsigned line;
+    const char* function;
+    uint64_t suppressed;
+    Format format;
+    std::tuple<Args...> args;
+
+    /**
+     * @brief Formats the record into the output and destroys it
+     */
+    static void process(void* ptr, std::string& out) {
+        auto record = static_cast<LogRecord*>(ptr);
+        formatTuple(out, formatString(record->format), record->args,
+                typename make_index_sequence<sizeof...(Args)>::type());
+        appendSuppressed(out, record->suppressed);
+        appendLocation(out, record->file, record->line, record->function);
+        record->~LogRecord();
+    }
+};
+
+/**
+ * @brief Header in front of every record in the ring
+ *
+ * Records with a null process function are padding up to the end of the ring.
+ */
+struct RecordHeader {
+    uint32_t size;
+    LogLevel level;
+    void (*process)(void*, std::string&);
+};
+
+constexpr size_t RECORD_ALIGNMENT = 16;
+
+static_assert(sizeof(RecordHeader) <= RECORD_ALIGNMENT, "Record header too large");
+
+constexpr size_t recordSize(size_t payload) {
+    return RECORD_ALIGNMENT + ((payload + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1));
+}
+
+/**
+ * @brief Single producer single consumer ring of log records
+ *
+ * The producer is the thread owning the ring, the consumer is the background thread of the asynchronous logger.
+ */
+class LogRing {
+public:
+    explicit LogRing(size_t capacity);
+
+    /**
+     * @brief Destroys the records that were committed but never consumed
+     */
+    ~LogRing();
+
+    size_t capacity() const {
+        return mCapacity;
+    }
+
+    /**
+     * @brief Reserves space for a record of the given size (as returned by recordSize)
+     *
+     * @return Pointer to the record header or null if the ring is full
+     */
+    RecordHeader* reserve(size_t size) {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        auto index = tail & (mCapacity - 1);
+        auto contiguous = mCapacity - index;
+        auto total = (size > contiguous ? contiguous + size : size);
+        if (mCapacity - (tail - mCachedHead) < total) {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (mCapacity - (tail - mCachedHead) < total) {
+                return nullptr;
+            }
+        }
+        if (size > contiguous) {
+            // Pad the remaining space at the end of the ring
+            auto padding = reinterpret_cast<RecordHeader*>(mBuffer.get() + index);
+            padding->size = static_cast<uint32_t>(contiguous);
+            padding->process = nullptr;
+            index = 0;
+        }
+        mReserved = total;
+        return reinterpret_cast<RecordHeader*>(mBuffer.get() + index);
+    }
+
+    /**
+     * @brief Publishes the record previously reserved
+     */
+    void commit() {
+        mTail.store(mTail.load(std::memory_order_relaxed) + mReserved, std::memory_order_release);
+    }
+
+    /**
+     * @brief Processes all committed records
+     *
+     * @return Number of records processed
+     */
+    template<class Fun>
+    size_t consume(Fun fun) {
+        auto head = mHead.load(std::memory_order_relaxed);
+        auto tail = mTail.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (head != tail) {
+            auto header = reinterpret_cast<RecordHeader*>(mBuffer.get() + (head & (mCapacity - 1)));
+            if (header->process) {
+                fun(*header, reinterpret_cast<char*>(header) + RECORD_ALIGNMENT);
+                ++count;
+            }
+            head += header->size;
+        }
+        mHead.store(head, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+    /// Set when the owning thread terminated
+    std::atomic<bool> closed;
+
+    /// Number of records dropped because the ring was full
+    std::atomic<uint64_t> dropped;
+
+private:
+    size_t mCapacity;
+    std::unique_ptr<char[]> mBuffer;
+
+    alignas(64) std::atomic<uint64_t> mHead;
+
+    alignas(64) std::atomic<uint64_t> mTail;
+    uint64_t mCachedHead;
+    size_t mReserved;
+};
+
+class AsyncBackend;
+
+} // namespace impl
+
 class LoggerT {
-    std::mutex mTraceMutex;
-    std::mutex mDebugMutex;
-    std::mutex mInfoMutex;
-    std::mutex mWarnMutex;
-    std::mutex mErrorMutex;
-    std::mutex mFatalMutex;
-
-    template<class...Args>
+    friend class impl::AsyncBackend;
+
+    /// Serialize the writes to standard output, standard error (std::cerr and std::clog) and all other streams
+    std::mutex mStdoutMutex;
+    std::mutex mStderrMutex;
+    std::mutex mOtherMutex;
+
+    template<class Format, class...Args>
     void log(
         LogLevel level,
         std::ostream& stream,
-        std::mutex& mutex,
         const char* file,
         unsigned line,
         const char* function,
-        const crossbow::string& str,
+        uint64_t suppressed,
+        const Format& str,
         Args&&... args) {
-        if (config.level > level) return;
-        boost::format formatter(str.c_str());
-        LogFormatter<Args...> fmt;
-        fmt.format(formatter, std::forward<Args>(args)...);
-        std::lock_guard<std::mutex> _(mutex);
-        stream << formatter.str();
-        stream << " (in " << function << " at " << file << ':' << line << ')' << std::endl;
+        if (!isEnabled(level)) return;
+        if (auto backend = mAsync.load(std::memory_order_acquire)) {
+            enqueue(std::integral_constant<bool, impl::is_recordable<Args...>::value>(), backend, level, file, line,
+                    function, suppressed, str, std::forward<Args>(args)...);
+            return;
+        }
+        auto& out = impl::threadBuffer();
+        out.clear();
+        impl::format(out, impl::formatString(str), args...);
+        impl::appendSuppressed(out, suppressed);
+        impl::appendLocation(out, file, line, function);
+        std::lock_guard<std::mutex> _(streamMutex(stream));
+        stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+        stream.flush();
+    }
+
+    template<class Format, class... Args>
+    void enqueue(std::true_type, impl::AsyncBackend* backend, LogLevel level, const char* file, unsigned line,
+            const char* function, uint64_t suppressed, const Format& str, Args&&... args) {
+        logAsync<impl::record_format_t<Format>, impl::record_arg_t<Args>...>(backend, level, file, line, function,
+                suppressed, str, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Formats the message on the logging thread as not all arguments can be stored in the record
+     */
+    template<class Format, class... Args>
+    void enqueue(std::false_type, impl::AsyncBackend* backend, LogLevel level, const char* file, unsigned line,
+            const char* function, uint64_t suppressed, const Format& str, Args&&... args) {
+        std::string message;
+        impl::format(message, impl::formatString(str), args...);
+        logAsync<const char*, std::string>(backend, level, file, line, function, suppressed, "%1%",
+                std::move(message));
+    }
+
+    template<class RecordFormat, class... RecordArgs, class Format, class... Args>
+    void logAsync(impl::AsyncBackend* backend, LogLevel level, const char* file, unsigned line, const char* function,
+            uint64_t suppressed, const Format& format, Args&&... args) {
+        using Record = impl::LogRecord<RecordFormat, RecordArgs...>;
+        static_assert(alignof(Record) <= impl::RECORD_ALIGNMENT, "Log record alignment not supported");
+        constexpr size_t size = impl::recordSize(sizeof(Record));
+
+        auto& ring = threadRing(backend);
+        if (size > ring.capacity() / 2) {
+            // Records too large for the ring are formatted synchronously
+            typename std::aligned_storage<sizeof(Record), alignof(Record)>::type storage;
+            new (&storage) Record(file, line, function, suppressed, format, std::forward<Args>(args)...);
+            std::string out;
+            Record::process(&storage, out);
+            writeSync(level, out);
+            return;
+        }
+        auto header = ring.reserve(size);
+        while (!header) {
+            if (!waitForSpace(backend, ring)) {
+                return;
+            }
+            header = ring.reserve(size);
+        }
+        header->size = static_cast<uint32_t>(size);
+        header->level = level;
+        header->process = &Record::process;
+        new (reinterpret_cast<char*>(header) + impl::RECORD_ALIGNMENT) Record(file, line, function, suppressed,
+                format, std::forward<Args>(args)...);
+        ring.commit();
     }
 
+    impl::LogRing& threadRing(impl::AsyncBackend* backend);
+
+    /**
+     * @brief Handles a full ring according to the overflow policy
+     *
+     * @return Whether the record should be retried
+     */
+    bool waitForSpace(impl::AsyncBackend* backend, impl::LogRing& ring);
+
+    void writeSync(LogLevel level, const std::string& out);
+
+    std::ostream& levelStream(LogLevel level);
+
+    std::mutex& streamMutex(const std::ostream& stream);
+
+    std::atomic<impl::AsyncBackend*> mAsync;
+
+    /// All backends ever started, the last one is the current one
+    ///
+    /// Stopped backends are never freed as logging threads might still hold a pointer to them.
+    std::vector<std::unique_ptr<impl::AsyncBackend>> mBackends;
+    std::mutex mAsyncMutex;
+
+    std::atomic<BinaryLogSink*> mBinarySink;
+    std::vector<std::shared_ptr<BinaryLogSink>> mBinarySinks;
+
 public:
     LoggerConfig config;
 
+    LoggerT();
+
     ~LoggerT();
 
-    template<class...Args>
-    void trace(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::TRACE, *(config.traceOut), mTraceMutex, file, line, function, str, std::forward<Args>(args)...);
+    /**
+     * @brief Switches the logger into asynchronous mode
+     *
+     * Every logging thread writes its records into its own ring buffer, a background thread formats the records and
+     * writes them in batches to the configured output streams. The output streams must not be used by other threads
+     * while the logger is in asynchronous mode.
+     *
+     * @param ringSize Size of the ring buffer of each thread in bytes (rounded up to a power of two)
+     * @param policy Behaviour when the ring buffer of a thread is full
+     */
+    void startAsync(size_t ringSize = 1024 * 1024, OverflowPolicy policy = OverflowPolicy::BLOCK);
+
+    /**
+     * @brief Writes all pending records and switches the logger back into synchronous mode
+     *
+     * Records of threads still logging while the logger is stopped are written with the next call to startAsync or
+     * when the logger is destroyed.
+     */
+    void stopAsync();
+
+    /*
+     * The format is either a string literal (which is not copied) or anything convertible to crossbow::string.
+     */
+
+    /**
+     * @brief Writes the binary logging statements (BINLOG_*) into the sink
+     *
+     * Binary logging statements are logged as text while no sink is set. Sinks are kept alive until the logger is
+     * destroyed as other threads might still be writing to them.
+     */
+    void setBinarySink(std::shared_ptr<BinaryLogSink> sink);
+
+    /**
+     * @param text Whether the statement is logged as text while no sink is set
+     */
+    template<class Format, class... Args>
+    void binary(const CallSite& site, bool text, const Format& str, Args&&... args) {
+        if (auto sink = mBinarySink.load(std::memory_order_acquire)) {
+            sink->write(site, args...);
+            return;
+        }
+        if (!text) return;
+        log(site.level, levelStream(site.level), site.file, site.line, site.function, 0, str,
+                std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Logs a message of a rate limited logging statement
+     *
+     * @param suppressed Number of messages suppressed since the last message of the statement
+     */
+    template<class Format, class... Args>
+    void limited(LogLevel level, uint64_t suppressed, const char* file, unsigned line, const char* function,
+            const Format& str, Args&&... args) {
+        log(level, levelStream(level), file, line, function, suppressed, str,
+                std::forward<Args>(args)...);
+    }
+
+    template<class Format, class...Args>
+    void trace(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::TRACE, *(config.traceOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 
-    template<class...Args>
-    void debug(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::DEBUG, *(config.debugOut), mDebugMutex, file, line, function, str, std::forward<Args>(args)...);
+    template<class Format, class...Args>
+    void debug(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::DEBUG, *(config.debugOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 
-    template<class...Args>
-    void info(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::INFO, *(config.infoOut), mInfoMutex, file, line, function, str, std::forward<Args>(args)...);
+    template<class Format, class...Args>
+    void info(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::INFO, *(config.infoOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 
-    template<class...Args>
-    void warn(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::WARN, *(config.warnOut), mWarnMutex, file, line, function, str, std::forward<Args>(args)...);
+    template<class Format, class...Args>
+    void warn(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::WARN, *(config.warnOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 
-    template<class...Args>
-    void error(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::ERROR, *(config.errorOut), mInfoMutex, file, line, function, str, std::forward<Args>(args)...);
+    template<class Format, class...Args>
+    void error(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::ERROR, *(config.errorOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 
-    template<class...Args>
-    void fatal(const char* file, unsigned line, const char* function, const crossbow::string& str, Args&&... args) {
-        log(LogLevel::FATAL, *(config.fatalOut), mInfoMutex, file, line, function, str, std::forward<Args>(args)...);
+    template<class Format, class...Args>
+    void fatal(const char* file, unsigned line, const char* function, const Format& str, Args&&... args) {
+        log(LogLevel::FATAL, *(config.fatalOut), file, line, function, 0, str,
+                std::forward<Args>(args)...);
     }
 };
 
@@ -144,24 +583,142 @@ using Logger = crossbow::singleton<LoggerT>;
 
 extern Logger logger;
 
-#ifdef NDEBUG
-#define LOG_TRACE(...)
+/*
+ * Minimum log level compiled into the binary (0 = TRACE ... 5 = FATAL)
+ *
+ * Logging statements below this level are removed at compile time. Defaults to DEBUG in release builds.
+ */
+#ifndef CROSSBOW_LOG_MIN_LEVEL
+#   ifdef NDEBUG
+#       define CROSSBOW_LOG_MIN_LEVEL 1
+#   else
+#       define CROSSBOW_LOG_MIN_LEVEL 0
+#   endif
+#endif // CROSSBOW_LOG_MIN_LEVEL
+
+/**
+ * @brief Whether logging statements of the level are compiled in given the minimum level
+ *
+ * A function instead of a comparison in the macros, as comparing against a minimum of 0 warns under -Wtype-limits.
+ */
+constexpr bool levelEnabled(LogLevel level, int minLevel) {
+    return static_cast<int>(level) >= minLevel;
+}
+
+/*
+ * Define CROSSBOW_LOG_CHECK_FORMAT to verify at compile time that the placeholders of every format passed to the
+ * logging macros match the number of arguments. Requires all formats to be string literals.
+ */
+#define CROSSBOW_LOG_FORMAT_ARG(format, ...) format
+
+#ifdef CROSSBOW_LOG_CHECK_FORMAT
+#   define CROSSBOW_LOG_ASSERT_FORMAT(...) static_assert(crossbow::logger::impl::checkFormat(\
+            CROSSBOW_LOG_FORMAT_ARG(__VA_ARGS__, 0),\
+            decltype(crossbow::logger::impl::argumentCount(__VA_ARGS__))::value - 1), "Invalid log format")
 #else
-#define LOG_TRACE(...) crossbow::logger::logger->trace(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
-#endif
-#define LOG_DEBUG(...) crossbow::logger::logger->debug(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
-#define LOG_INFO(...) crossbow::logger::logger->info(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
-#define LOG_WARN(...) crossbow::logger::logger->warn(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
-#define LOG_ERROR(...) crossbow::logger::logger->error(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
-#define LOG_FATAL(...) crossbow::logger::logger->fatal(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
+#   define CROSSBOW_LOG_ASSERT_FORMAT(...)
+#endif // CROSSBOW_LOG_CHECK_FORMAT
+
+/*
+ * The level is checked before any argument is evaluated
+ */
+#define CROSSBOW_LOG(Level, fun, ...) do {\
+        CROSSBOW_LOG_ASSERT_FORMAT(__VA_ARGS__);\
+        if (crossbow::logger::levelEnabled(crossbow::logger::LogLevel::Level, CROSSBOW_LOG_MIN_LEVEL)\
+                && crossbow::logger::isEnabled(crossbow::logger::LogLevel::Level)) {\
+            crossbow::logger::logger->fun(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);\
+        }\
+    } while (false)
+
+#define LOG_TRACE(...) CROSSBOW_LOG(TRACE, trace, __VA_ARGS__)
+#define LOG_DEBUG(...) CROSSBOW_LOG(DEBUG, debug, __VA_ARGS__)
+#define LOG_INFO(...) CROSSBOW_LOG(INFO, info, __VA_ARGS__)
+#define LOG_WARN(...) CROSSBOW_LOG(WARN, warn, __VA_ARGS__)
+#define LOG_ERROR(...) CROSSBOW_LOG(ERROR, error, __VA_ARGS__)
+#define LOG_FATAL(...) CROSSBOW_LOG(FATAL, fatal, __VA_ARGS__)
+
+/*
+ * Rate limited logging statements
+ *
+ * LOG_<LEVEL>_EVERY_N(n, ...) logs the first of every n messages, LOG_<LEVEL>_EVERY_MS(ms, ...) logs at most one
+ * message per interval and LOG_<LEVEL>_RATE(rate, burst, ...) logs up to rate messages per second with bursts of up
+ * to burst messages. The state is kept per statement and checked without locks, logged messages report the number of
+ * messages suppressed since the last logged message.
+ */
+#define CROSSBOW_LOG_UNPACK(...) __VA_ARGS__
+
+#define CROSSBOW_LOG_LIMITED(Level, State, Limit, ...) do {\
+        CROSSBOW_LOG_ASSERT_FORMAT(__VA_ARGS__);\
+        if (crossbow::logger::levelEnabled(crossbow::logger::LogLevel::Level, CROSSBOW_LOG_MIN_LEVEL)\
+                && crossbow::logger::isEnabled(crossbow::logger::LogLevel::Level)) {\
+            static crossbow::logger::impl::State crossbowLimiter;\
+            uint64_t crossbowSuppressed = 0;\
+            if (crossbowLimiter.next(CROSSBOW_LOG_UNPACK Limit, crossbowSuppressed)) {\
+                crossbow::logger::logger->limited(crossbow::logger::LogLevel::Level, crossbowSuppressed, __FILE__,\
+                        __LINE__, __FUNCTION__, __VA_ARGS__);\
+            }\
+        }\
+    } while (false)
+
+#define LOG_TRACE_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(TRACE, EveryN, (n), __VA_ARGS__)
+#define LOG_DEBUG_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(DEBUG, EveryN, (n), __VA_ARGS__)
+#define LOG_INFO_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(INFO, EveryN, (n), __VA_ARGS__)
+#define LOG_WARN_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(WARN, EveryN, (n), __VA_ARGS__)
+#define LOG_ERROR_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(ERROR, EveryN, (n), __VA_ARGS__)
+#define LOG_FATAL_EVERY_N(n, ...) CROSSBOW_LOG_LIMITED(FATAL, EveryN, (n), __VA_ARGS__)
+
+#define LOG_TRACE_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(TRACE, EveryInterval, (ms), __VA_ARGS__)
+#define LOG_DEBUG_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(DEBUG, EveryInterval, (ms), __VA_ARGS__)
+#define LOG_INFO_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(INFO, EveryInterval, (ms), __VA_ARGS__)
+#define LOG_WARN_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(WARN, EveryInterval, (ms), __VA_ARGS__)
+#define LOG_ERROR_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(ERROR, EveryInterval, (ms), __VA_ARGS__)
+#define LOG_FATAL_EVERY_MS(ms, ...) CROSSBOW_LOG_LIMITED(FATAL, EveryInterval, (ms), __VA_ARGS__)
+
+#define LOG_TRACE_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(TRACE, TokenBucket, (rate, burst), __VA_ARGS__)
+#define LOG_DEBUG_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(DEBUG, TokenBucket, (rate, burst), __VA_ARGS__)
+#define LOG_INFO_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(INFO, TokenBucket, (rate, burst), __VA_ARGS__)
+#define LOG_WARN_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(WARN, TokenBucket, (rate, burst), __VA_ARGS__)
+#define LOG_ERROR_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(ERROR, TokenBucket, (rate, burst), __VA_ARGS__)
+#define LOG_FATAL_RATE(rate, burst, ...) CROSSBOW_LOG_LIMITED(FATAL, TokenBucket, (rate, burst), __VA_ARGS__)
+/*
+ * Binary logging statements are written to the binary sink of the logger (if set) and formatted offline. The format
+ * must be a string literal. As they are meant to stay enabled in production builds they are only removed below
+ * CROSSBOW_BINLOG_MIN_LEVEL (defaults to TRACE). Without a sink they are logged as text if the level is not below
+ * CROSSBOW_LOG_MIN_LEVEL.
+ */
+#ifndef CROSSBOW_BINLOG_MIN_LEVEL
+#   define CROSSBOW_BINLOG_MIN_LEVEL 0
+#endif // CROSSBOW_BINLOG_MIN_LEVEL
+
+#define CROSSBOW_BINLOG(Level, ...) do {\
+        CROSSBOW_LOG_ASSERT_FORMAT(__VA_ARGS__);\
+        if (crossbow::logger::levelEnabled(crossbow::logger::LogLevel::Level, CROSSBOW_BINLOG_MIN_LEVEL)\
+                && crossbow::logger::isEnabled(crossbow::logger::LogLevel::Level)) {\
+            static const crossbow::logger::CallSite crossbowCallSite(crossbow::logger::LogLevel::Level, __FILE__,\
+                    __LINE__, __FUNCTION__, CROSSBOW_LOG_FORMAT_ARG(__VA_ARGS__, 0));\
+            crossbow::logger::logger->binary(crossbowCallSite,\
+                    crossbow::logger::levelEnabled(crossbow::logger::LogLevel::Level, CROSSBOW_LOG_MIN_LEVEL),\
+                    __VA_ARGS__);\
+        }\
+    } while (false)
+
+#define BINLOG_TRACE(...) CROSSBOW_BINLOG(TRACE, __VA_ARGS__)
+#define BINLOG_DEBUG(...) CROSSBOW_BINLOG(DEBUG, __VA_ARGS__)
+#define BINLOG_INFO(...) CROSSBOW_BINLOG(INFO, __VA_ARGS__)
+#define BINLOG_WARN(...) CROSSBOW_BINLOG(WARN, __VA_ARGS__)
+#define BINLOG_ERROR(...) CROSSBOW_BINLOG(ERROR, __VA_ARGS__)
+#define BINLOG_FATAL(...) CROSSBOW_BINLOG(FATAL, __VA_ARGS__)
+
 #ifdef NDEBUG
 #   define LOG_ASSERT(...)
 #else
-#   define LOG_ASSERT(Cond, ...) if (!(Cond)) {\
-            std::cerr << "Assertion Failed: " #Cond ":" << std::endl;\
-            LOG_FATAL(__VA_ARGS__);\
-            std::terminate();\
-        }
+#   define LOG_ASSERT(Cond, ...) do {\
+            if (!(Cond)) {\
+                std::cerr << "Assertion Failed: " #Cond ":" << std::endl;\
+                crossbow::logger::logger->fatal(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__);\
+                std::terminate();\
+            }\
+        } while (false)
 #endif // NDEBUG
 
 } // namespace logger
@@ -0,0 +1,385 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/logger/format.hpp>
+#include <crossbow/string.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace crossbow {
+namespace logger {
+
+enum class LogLevel : unsigned char;
+
+/**
+ * @brief Static description of a logging statement
+ *
+ * Every binary logging statement owns one call site. Records only carry the id of the call site, the sink writes the
+ * description once per file and remembers the file in definedIn.
+ */
+struct CallSite {
+    CallSite(LogLevel l, const char* f, unsigned ln, const char* fun, const char* fmt);
+
+    const uint32_t id;
+    const LogLevel level;
+    const char* const file;
+    const unsigned line;
+    const char* const function;
+    const char* const format;
+
+    /// Id of the last file the description was written to (0 if none)
+    mutable std::atomic<uint64_t> definedIn;
+};
+
+namespace impl {
+
+/**
+ * @brief Reads the timestamp counter (or a monotonic clock on architectures without one)
+ */
+inline uint64_t readTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Binary log file format
+ *
+ * Every file starts with a FileHeader followed by a sequence of records. Each record starts with a RecordHeader
+ * (stored unaligned), site records contain the line followed by the file, function and format strings, log records
+ * contain the tagged arguments. All integers are stored in native byte order, strings are prefixed by their 32 bit
+ * length. A zero size marks the end of the records.
+ */
+namespace binary {
+
+constexpr char MAGIC[8] = {'C', 'B', 'B', 'I', 'N', 'L', 'O', 'G'};
+
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t timestamp;
+    int64_t realtime;
+    double ticksPerNanosecond;
+};
+
+enum class RecordKind : uint8_t {
+    SITE = 1,
+    LOG,
+};
+
+struct RecordHeader {
+    uint32_t size;
+    RecordKind kind;
+    LogLevel level;
+    uint32_t site;
+    uint64_t timestamp;
+};
+
+constexpr size_t RECORD_HEADER_SIZE = sizeof(uint32_t) + 2 * sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+enum class ArgumentType : uint8_t {
+    INT = 1,
+    UINT,
+    DOUBLE,
+    STRING,
+    CHAR,
+    BOOL,
+    POINTER,
+};
+
+void writeRecordHeader(char* out, const RecordHeader& header);
+
+RecordHeader readRecordHeader(const char* in);
+
+template<class T>
+void append(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void appendString(std::string& out, const char* str, size_t length) {
+    append(out, static_cast<uint32_t>(length));
+    out.append(str, length);
+}
+
+template<class T>
+typename std::enable_if<is_plain_integer<T>::value && std::is_signed<T>::value>::type
+encode(std::string& out, T value) {
+    append(out, ArgumentType::INT);
+    append(out, static_cast<int64_t>(value));
+}
+
+template<class T>
+typename std::enable_if<is_plain_integer<T>::value && std::is_unsigned<T>::value>::type
+encode(std::string& out, T value) {
+    append(out, ArgumentType::UINT);
+    append(out, static_cast<uint64_t>(value));
+}
+
+template<class T>
+struct is_unscoped_enum : std::integral_constant<bool, std::is_enum<T>::value
+        && std::is_convertible<T, long long>::value> {
+};
+
+/**
+ * @brief Unscoped enums are stored as integer (like std::ostream prints them), scoped enums use their stream operator
+ */
+template<class T>
+typename std::enable_if<is_unscoped_enum<T>::value>::type encode(std::string& out, T value) {
+    using underlying = typename std::underlying_type<T>::type;
+    if (std::is_signed<underlying>::value) {
+        append(out, ArgumentType::INT);
+        append(out, static_cast<int64_t>(value));
+    } else {
+        append(out, ArgumentType::UINT);
+        append(out, static_cast<uint64_t>(value));
+    }
+}
+
+template<class T>
+typename std::enable_if<std::is_floating_point<T>::value>::type encode(std::string& out, T value) {
+    append(out, ArgumentType::DOUBLE);
+    append(out, static_cast<double>(value));
+}
+
+inline void encode(std::string& out, bool value) {
+    append(out, ArgumentType::BOOL);
+    append(out, static_cast<uint8_t>(value ? 1 : 0));
+}
+
+inline void encode(std::string& out, char value) {
+    append(out, ArgumentType::CHAR);
+    append(out, value);
+}
+
+inline void encode(std::string& out, signed char value) {
+    encode(out, static_cast<char>(value));
+}
+
+inline void encode(std::string& out, unsigned char value) {
+    encode(out, static_cast<char>(value));
+}
+
+inline void encode(std::string& out, const char* value) {
+    append(out, ArgumentType::STRING);
+    appendString(out, value ? value : "", value ? strlen(value) : 0);
+}
+
+inline void encode(std::string& out, char* value) {
+    encode(out, static_cast<const char*>(value));
+}
+
+inline void encode(std::string& out, const std::string& value) {
+    append(out, ArgumentType::STRING);
+    appendString(out, value.data(), value.size());
+}
+
+inline void encode(std::string& out, const crossbow::string& value) {
+    append(out, ArgumentType::STRING);
+    appendString(out, value.data(), value.size());
+}
+
+template<class T>
+typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type
+encode(std::string& out, T* value) {
+    append(out, ArgumentType::POINTER);
+    append(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+}
+
+/**
+ * @brief Types without a binary representation are stored as formatted string
+ */
+template<class T>
+typename std::enable_if<!std::is_arithmetic<T>::value && !is_unscoped_enum<T>::value
+        && !std::is_pointer<T>::value>::type
+encode(std::string& out, const T& value) {
+    append(out, ArgumentType::STRING);
+    auto offset = out.size();
+    append(out, uint32_t(0));
+    appendValue(out, value);
+    auto length = static_cast<uint32_t>(out.size() - offset - sizeof(uint32_t));
+    memcpy(&out[offset], &length, sizeof(length));
+}
+
+inline void encodeArguments(std::string&) {
+}
+
+template<class Head, class... Tail>
+void encodeArguments(std::string& out, const Head& head, const Tail&... tail) {
+    encode(out, head);
+    encodeArguments(out, tail...);
+}
+
+/**
+ * @brief Thread local buffer used to encode records
+ */
+std::string& threadBuffer();
+
+} // namespace binary
+} // namespace impl
+
+/**
+ * @brief Logger sink writing binary records into memory mapped and rotating files
+ *
+ * Records contain the timestamp counter, the level, the id of the call site and the raw arguments. Formatting is
+ * deferred to the offline decoder (crossbow_logdecode). Files are named <path>.<sequence number>, a new file is started
+ * when the current one is full and only the most recent files are kept.
+ *
+ * Writers reserve space in the mapped file with an atomic increment of the file offset and copy their record without
+ * holding a lock. The writer whose reservation overflows the file creates the next file while the other writers of the
+ * full file wait for it, the full file is closed by whichever writer finishes last.
+ */
+class BinaryLogSink {
+public:
+    /**
+     * @param path Path prefix of the log files
+     * @param fileSize Size of every file in bytes
+     * @param maxFiles Number of files to keep (0 to keep all files)
+     */
+    BinaryLogSink(std::string path, size_t fileSize = 64 * 1024 * 1024, size_t maxFiles = 8);
+
+    ~BinaryLogSink();
+
+    template<class... Args>
+    void write(const CallSite& site, const Args&... args) {
+        auto timestamp = impl::readTimestamp();
+        auto& out = impl::binary::threadBuffer();
+        out.resize(impl::binary::RECORD_HEADER_SIZE);
+        impl::binary::encodeArguments(out, args...);
+        impl::binary::writeRecordHeader(&out[0], impl::binary::RecordHeader{static_cast<uint32_t>(out.size()),
+                impl::binary::RecordKind::LOG, site.level, site.id, timestamp});
+        append(site, out);
+    }
+
+    /**
+     * @brief Number of records dropped because they did not fit into a file or the file could not be created
+     */
+    uint64_t dropped() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Path of the file currently written
+     */
+    std::string currentFile() const;
+
+private:
+    struct File;
+
+    void append(const CallSite& site, const std::string& record);
+
+    void rotate(File* full, size_t used);
+
+    File* openFile();
+
+    void release(File& file);
+
+    std::string mPath;
+    size_t mFileSize;
+    size_t mMaxFiles;
+    double mTicksPerNanosecond;
+
+    /// File records are appended to (null if the last file could not be created)
+    std::atomic<File*> mCurrent;
+
+    /// Sequence number of the last file created
+    std::atomic<uint64_t> mSequence;
+
+    /// All files created, writers might still access the state of a full file after it was replaced
+    std::vector<std::unique_ptr<File>> mFiles;
+
+    std::atomic<uint64_t> mDropped;
+};
+
+/**
+ * @brief Decoded record of a binary log file
+ *
+ * The file and function strings are owned by the reader.
+ */
+struct BinaryLogEntry {
+    LogLevel level;
+
+    /// Wall clock time in nanoseconds since the epoch
+    int64_t time;
+
+    const char* file;
+    unsigned line;
+    const char* function;
+
+    /// Formatted message
+    std::string message;
+};
+
+/**
+ * @brief Reads the records of a binary log file
+ */
+class BinaryLogReader {
+public:
+    /**
+     * @throws std::runtime_error If the file can not be read or is not a binary log file
+     */
+    explicit BinaryLogReader(const std::string& path);
+
+    /**
+     * @brief Decodes the next record
+     *
+     * @return False if all records were read
+     * @throws std::runtime_error If the file is corrupted
+     */
+    bool next(BinaryLogEntry& entry);
+
+private:
+    struct Site {
+        LogLevel level;
+        std::string file;
+        unsigned line;
+        std::string function;
+        std::string format;
+    };
+
+    std::vector<char> mData;
+    size_t mOffset;
+    impl::binary::FileHeader mHeader;
+    std::vector<Site> mSites;
+};
+
+} // namespace logger
+} // namespace crossbow
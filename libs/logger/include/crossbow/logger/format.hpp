@@ -0,0 +1,228 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <crossbow/string.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace crossbow {
+namespace logger {
+namespace impl {
+
+/**
+ * @brief Checks at compile time that every placeholder in the format refers to one of the arguments
+ *
+ * Valid formats only contain placeholders of the form %N% (with 1 <= N <= numArgs) and escaped %%.
+ */
+constexpr bool checkFormat(const char* str, size_t numArgs, bool inPlaceholder = false, size_t number = 0,
+        bool digits = false) {
+    return (!inPlaceholder
+            ? (str[0] == '\0' || checkFormat(str + 1, numArgs, str[0] == '%'))
+            : (str[0] >= '0' && str[0] <= '9'
+                ? checkFormat(str + 1, numArgs, true, number * 10 + static_cast<size_t>(str[0] - '0'), true)
+                : (str[0] == '%'
+                    && (!digits || (number >= 1 && number <= numArgs))
+                    && checkFormat(str + 1, numArgs))));
+}
+
+template<class... Args>
+std::integral_constant<size_t, sizeof...(Args)> argumentCount(const Args&...);
+
+extern const char gDigitPairs[201];
+
+/**
+ * @brief Appends the decimal representation of the value
+ */
+inline void appendUnsigned(std::string& out, uint64_t value) {
+    char buffer[20];
+    auto end = buffer + sizeof(buffer);
+    auto pos = end;
+    while (value >= 100) {
+        auto index = (value % 100) * 2;
+        value /= 100;
+        pos -= 2;
+        pos[0] = gDigitPairs[index];
+        pos[1] = gDigitPairs[index + 1];
+    }
+    if (value >= 10) {
+        auto index = value * 2;
+        pos -= 2;
+        pos[0] = gDigitPairs[index];
+        pos[1] = gDigitPairs[index + 1];
+    } else {
+        *--pos = static_cast<char>('0' + value);
+    }
+    out.append(pos, static_cast<size_t>(end - pos));
+}
+
+inline void appendSigned(std::string& out, int64_t value) {
+    if (value < 0) {
+        out.push_back('-');
+        appendUnsigned(out, ~static_cast<uint64_t>(value) + 1);
+    } else {
+        appendUnsigned(out, static_cast<uint64_t>(value));
+    }
+}
+
+/**
+ * @brief Appends the value in the same representation as the default std::ostream formatting (%g)
+ */
+void appendDouble(std::string& out, double value);
+
+void appendLongDouble(std::string& out, long double value);
+
+void appendPointer(std::string& out, const void* value);
+
+/**
+ * @brief Stream appending to the string
+ *
+ * Used for types without builtin formatting. The stream is thread local and has the default formatting flags.
+ */
+std::ostream& stringStream(std::string& out);
+
+template<class T>
+struct is_plain_integer : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value
+        && !std::is_same<T, char>::value && !std::is_same<T, signed char>::value
+        && !std::is_same<T, unsigned char>::value> {
+};
+
+template<class T>
+typename std::enable_if<is_plain_integer<T>::value && std::is_signed<T>::value>::type
+appendValue(std::string& out, T value) {
+    appendSigned(out, static_cast<int64_t>(value));
+}
+
+template<class T>
+typename std::enable_if<is_plain_integer<T>::value && std::is_unsigned<T>::value>::type
+appendValue(std::string& out, T value) {
+    appendUnsigned(out, static_cast<uint64_t>(value));
+}
+
+inline void appendValue(std::string& out, bool value) {
+    out.push_back(value ? '1' : '0');
+}
+
+inline void appendValue(std::string& out, char value) {
+    out.push_back(value);
+}
+
+inline void appendValue(std::string& out, signed char value) {
+    out.push_back(static_cast<char>(value));
+}
+
+inline void appendValue(std::string& out, unsigned char value) {
+    out.push_back(static_cast<char>(value));
+}
+
+inline void appendValue(std::string& out, float value) {
+    appendDouble(out, value);
+}
+
+inline void appendValue(std::string& out, double value) {
+    appendDouble(out, value);
+}
+
+inline void appendValue(std::string& out, long double value) {
+    appendLongDouble(out, value);
+}
+
+inline void appendValue(std::string& out, const char* value) {
+    if (value) {
+        out.append(value);
+    }
+}
+
+inline void appendValue(std::string& out, char* value) {
+    appendValue(out, static_cast<const char*>(value));
+}
+
+inline void appendValue(std::string& out, const std::string& value) {
+    out.append(value);
+}
+
+inline void appendValue(std::string& out, const crossbow::string& value) {
+    out.append(value.data(), value.size());
+}
+
+template<class T>
+typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type
+appendValue(std::string& out, T* value) {
+    appendPointer(out, value);
+}
+
+template<class T>
+typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_pointer<T>::value>::type
+appendValue(std::string& out, const T& value) {
+    stringStream(out) << value;
+}
+
+template<class T>
+void appendArgument(std::string& out, const void* value) {
+    appendValue(out, *static_cast<const T*>(value));
+}
+
+/**
+ * @brief Type erased argument of the formatter
+ */
+struct FormatArgument {
+    const void* value;
+    void (*append)(std::string&, const void*);
+};
+
+/**
+ * @brief Appends the format with all placeholders replaced by the arguments
+ *
+ * Placeholders referring to missing arguments are copied verbatim.
+ */
+void formatArguments(std::string& out, const char* format, const FormatArgument* args, size_t numArgs);
+
+inline void format(std::string& out, const char* format) {
+    formatArguments(out, format, nullptr, 0);
+}
+
+/**
+ * @brief Formats the %N% placeholder syntax directly into the output string
+ *
+ * Integers, floating point numbers, strings and pointers are formatted without going through a stream, all other
+ * types are printed with their stream operator.
+ */
+template<class... Args>
+void format(std::string& out, const char* format, const Args&... args) {
+    const FormatArgument arguments[] = {FormatArgument{&args, &appendArgument<Args>}...};
+    formatArguments(out, format, arguments, sizeof...(Args));
+}
+
+/**
+ * @brief Thread local buffer used to format log messages
+ */
+std::string& threadBuffer();
+
+} // namespace impl
+} // namespace logger
+} // namespace crossbow
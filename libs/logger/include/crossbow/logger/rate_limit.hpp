@@ -0,0 +1,138 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace crossbow {
+namespace logger {
+namespace impl {
+
+inline int64_t monotonicNanoseconds() {
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*
+ * State of rate limited logging statements
+ *
+ * Every statement owns a static instance. The constructors are constexpr so the state is initialized at compile time
+ * and the statement does not need a guard for the static initialization. All functions are lock-free, they return
+ * whether the message should be logged and in that case the number of messages suppressed since the last one.
+ */
+
+/**
+ * @brief Logs the first of every n messages
+ */
+class EveryN {
+public:
+    constexpr EveryN()
+            : mCount(0) {
+    }
+
+    bool next(uint64_t n, uint64_t& suppressed) {
+        auto count = mCount.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 1) {
+            suppressed = 0;
+            return true;
+        }
+        if (count % n != 0) {
+            return false;
+        }
+        suppressed = (count == 0 ? 0 : n - 1);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> mCount;
+};
+
+/**
+ * @brief Logs at most one message per interval
+ */
+class EveryInterval {
+public:
+    constexpr EveryInterval()
+            : mNext(0),
+              mSuppressed(0) {
+    }
+
+    bool next(int64_t milliseconds, uint64_t& suppressed) {
+        auto now = monotonicNanoseconds();
+        auto next = mNext.load(std::memory_order_relaxed);
+        if (now < next || !mNext.compare_exchange_strong(next, now + milliseconds * 1000000,
+                std::memory_order_relaxed)) {
+            mSuppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = mSuppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<int64_t> mNext;
+    std::atomic<uint64_t> mSuppressed;
+};
+
+/**
+ * @brief Token bucket refilled with rate messages per second holding up to burst messages
+ *
+ * Implemented as generic cell rate algorithm: The bucket is represented by the theoretical arrival time of the next
+ * message, a message conforms if it does not arrive earlier than burst intervals before that time.
+ */
+class TokenBucket {
+public:
+    constexpr TokenBucket()
+            : mArrival(0),
+              mSuppressed(0) {
+    }
+
+    bool next(double rate, uint64_t burst, uint64_t& suppressed) {
+        auto interval = static_cast<int64_t>(1000000000.0 / rate);
+        auto tolerance = interval * static_cast<int64_t>(burst == 0 ? 1 : burst);
+        auto now = monotonicNanoseconds();
+        auto arrival = mArrival.load(std::memory_order_relaxed);
+        while (true) {
+            auto nextArrival = (arrival > now ? arrival : now) + interval;
+            if (nextArrival - now > tolerance) {
+                mSuppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (mArrival.compare_exchange_weak(arrival, nextArrival, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        suppressed = mSuppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<int64_t> mArrival;
+    std::atomic<uint64_t> mSuppressed;
+};
+
+} // namespace impl
+} // namespace logger
+} // namespace crossbow
@@ -0,0 +1,468 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger/binary_sink.hpp>
+#include <crossbow/logger.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace crossbow {
+namespace logger {
+
+namespace {
+
+std::atomic<uint32_t> gNextSiteId(1);
+
+/// Ids of the binary log files of all sinks, call sites remember the file containing their description
+std::atomic<uint64_t> gNextFileId(1);
+
+thread_local std::string gThreadBuffer;
+
+int64_t realtimeNanoseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Measures the frequency of the timestamp counter
+ */
+double calibrateTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    auto beginClock = std::chrono::steady_clock::now();
+    auto beginTimestamp = impl::readTimestamp();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto endClock = std::chrono::steady_clock::now();
+    auto endTimestamp = impl::readTimestamp();
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(endClock - beginClock).count();
+    return static_cast<double>(endTimestamp - beginTimestamp) / static_cast<double>(nanoseconds);
+#else
+    return 1.0;
+#endif
+}
+
+size_t siteRecordSize(const CallSite& site) {
+    return impl::binary::RECORD_HEADER_SIZE + sizeof(uint32_t) + 3 * sizeof(uint32_t) + strlen(site.file)
+            + strlen(site.function) + strlen(site.format);
+}
+
+char* writeString(char* out, const char* str) {
+    auto length = static_cast<uint32_t>(strlen(str));
+    memcpy(out, &length, sizeof(length));
+    memcpy(out + sizeof(length), str, length);
+    return out + sizeof(length) + length;
+}
+
+/**
+ * @brief Writes the site record describing the call site (of the given size) to out
+ */
+void writeSiteRecord(char* out, const CallSite& site, size_t size) {
+    impl::binary::writeRecordHeader(out, impl::binary::RecordHeader{static_cast<uint32_t>(size),
+            impl::binary::RecordKind::SITE, site.level, site.id, 0});
+    out += impl::binary::RECORD_HEADER_SIZE;
+    auto line = static_cast<uint32_t>(site.line);
+    memcpy(out, &line, sizeof(line));
+    out += sizeof(line);
+    out = writeString(out, site.file);
+    out = writeString(out, site.function);
+    writeString(out, site.format);
+}
+
+} // anonymous namespace
+
+CallSite::CallSite(LogLevel l, const char* f, unsigned ln, const char* fun, const char* fmt)
+        : id(gNextSiteId.fetch_add(1)),
+          level(l),
+          file(f),
+          line(ln),
+          function(fun),
+          format(fmt),
+          definedIn(0) {
+}
+
+namespace impl {
+namespace binary {
+
+void writeRecordHeader(char* out, const RecordHeader& header) {
+    memcpy(out, &header.size, sizeof(header.size));
+    out += sizeof(header.size);
+    memcpy(out, &header.kind, sizeof(header.kind));
+    out += sizeof(header.kind);
+    memcpy(out, &header.level, sizeof(header.level));
+    out += sizeof(header.level);
+    memcpy(out, &header.site, sizeof(header.site));
+    out += sizeof(header.site);
+    memcpy(out, &header.timestamp, sizeof(header.timestamp));
+}
+
+RecordHeader readRecordHeader(const char* in) {
+    RecordHeader header;
+    memcpy(&header.size, in, sizeof(header.size));
+    in += sizeof(header.size);
+    memcpy(&header.kind, in, sizeof(header.kind));
+    in += sizeof(header.kind);
+    memcpy(&header.level, in, sizeof(header.level));
+    in += sizeof(header.level);
+    memcpy(&header.site, in, sizeof(header.site));
+    in += sizeof(header.site);
+    memcpy(&header.timestamp, in, sizeof(header.timestamp));
+    return header;
+}
+
+std::string& threadBuffer() {
+    return gThreadBuffer;
+}
+
+} // namespace binary
+} // namespace impl
+
+struct BinaryLogSink::File {
+    /// Value of used while records are appended to the file
+    static constexpr size_t OPEN = std::numeric_limits<size_t>::max();
+
+    File(uint64_t seq, int f, char* d, size_t headerSize)
+            : id(gNextFileId.fetch_add(1)),
+              sequence(seq),
+              fd(f),
+              data(d),
+              offset(headerSize),
+              committed(headerSize),
+              used(OPEN),
+              closed(false) {
+    }
+
+    const uint64_t id;
+    const uint64_t sequence;
+    const int fd;
+    char* const data;
+
+    /// End of the space reserved by writers, exceeds the file size once the file is full
+    std::atomic<size_t> offset;
+
+    /// Number of bytes writers finished copying
+    std::atomic<size_t> committed;
+
+    /// Size of the records in the file once it was replaced
+    std::atomic<size_t> used;
+
+    std::atomic<bool> closed;
+};
+
+constexpr size_t BinaryLogSink::File::OPEN;
+
+BinaryLogSink::BinaryLogSink(std::string path, size_t fileSize, size_t maxFiles)
+        : mPath(std::move(path)),
+          mFileSize(fileSize),
+          mMaxFiles(maxFiles),
+          mTicksPerNanosecond(calibrateTimestamp()),
+          mCurrent(nullptr),
+          mSequence(0),
+          mDropped(0) {
+    if (mFileSize < sizeof(impl::binary::FileHeader) + impl::binary::RECORD_HEADER_SIZE) {
+        throw std::invalid_argument("File size too small");
+    }
+    auto file = openFile();
+    if (!file) {
+        throw std::system_error(errno, std::generic_category());
+    }
+    mCurrent.store(file);
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    auto file = mCurrent.load();
+    if (file) {
+        file->used.store(std::min(file->offset.load(), mFileSize));
+        release(*file);
+    }
+}
+
+std::string BinaryLogSink::currentFile() const {
+    auto file = mCurrent.load(std::memory_order_acquire);
+    return mPath + "." + std::to_string(file ? file->sequence : mSequence.load());
+}
+
+void BinaryLogSink::append(const CallSite& site, const std::string& record) {
+    // The site definition is written together with the first record of the site in every file
+    auto siteSize = siteRecordSize(site);
+    if (sizeof(impl::binary::FileHeader) + siteSize + record.size() > mFileSize) {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    while (true) {
+        auto file = mCurrent.load(std::memory_order_acquire);
+        if (!file) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Records of the site written after this one was seen are placed behind the definition
+        auto defined = (site.definedIn.load(std::memory_order_acquire) == file->id);
+        auto size = record.size() + (defined ? 0 : siteSize);
+        auto offset = file->offset.fetch_add(size);
+        if (offset + size <= mFileSize) {
+            auto out = file->data + offset;
+            if (!defined) {
+                writeSiteRecord(out, site, siteSize);
+                out += siteSize;
+            }
+            memcpy(out, record.data(), record.size());
+            if (!defined) {
+                site.definedIn.store(file->id, std::memory_order_release);
+            }
+            file->committed.fetch_add(size);
+            release(*file);
+            return;
+        }
+        if (offset <= mFileSize) {
+            // The reservation overflowed the file, the file ends before it
+            rotate(file, offset);
+        } else {
+            while (mCurrent.load(std::memory_order_acquire) == file) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+void BinaryLogSink::rotate(File* full, size_t used) {
+    mCurrent.store(openFile(), std::memory_order_release);
+
+    full->used.store(used);
+    release(*full);
+
+    auto sequence = mSequence.load();
+    if (mMaxFiles != 0 && sequence > mMaxFiles) {
+        auto oldFile = mPath + "." + std::to_string(sequence - mMaxFiles);
+        ::unlink(oldFile.c_str());
+    }
+}
+
+BinaryLogSink::File* BinaryLogSink::openFile() {
+    auto sequence = mSequence.fetch_add(1) + 1;
+    auto fileName = mPath + "." + std::to_string(sequence);
+    auto fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return nullptr;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mFileSize)) != 0) {
+        auto error = errno;
+        ::close(fd);
+        errno = error;
+        return nullptr;
+    }
+    auto data = ::mmap(nullptr, mFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        auto error = errno;
+        ::close(fd);
+        errno = error;
+        return nullptr;
+    }
+
+    impl::binary::FileHeader header;
+    memcpy(header.magic, impl::binary::MAGIC, sizeof(header.magic));
+    header.version = impl::binary::VERSION;
+    header.reserved = 0;
+    header.timestamp = impl::readTimestamp();
+    header.realtime = realtimeNanoseconds();
+    header.ticksPerNanosecond = mTicksPerNanosecond;
+    memcpy(data, &header, sizeof(header));
+
+    mFiles.emplace_back(new File(sequence, fd, reinterpret_cast<char*>(data), sizeof(header)));
+    return mFiles.back().get();
+}
+
+void BinaryLogSink::release(File& file) {
+    // Both the last writer and the writer replacing the file get here, only one of them closes it
+    auto used = file.used.load();
+    if (used == File::OPEN || file.committed.load() != used || file.closed.exchange(true)) {
+        return;
+    }
+    ::munmap(file.data, mFileSize);
+
+    // Cut off the unused space at the end of the file
+    if (::ftruncate(file.fd, static_cast<off_t>(used)) != 0) {
+        LOG_WARN("Unable to truncate binary log file [error = %1%]", errno);
+    }
+    ::close(file.fd);
+}
+
+BinaryLogReader::BinaryLogReader(const std::string& path)
+        : mOffset(sizeof(impl::binary::FileHeader)) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+    mData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (mData.size() < sizeof(mHeader)) {
+        throw std::runtime_error(path + " is not a binary log file");
+    }
+    memcpy(&mHeader, mData.data(), sizeof(mHeader));
+    if (memcmp(mHeader.magic, impl::binary::MAGIC, sizeof(mHeader.magic)) != 0) {
+        throw std::runtime_error(path + " is not a binary log file");
+    }
+    if (mHeader.version != impl::binary::VERSION) {
+        throw std::runtime_error("Unsupported binary log version " + std::to_string(mHeader.version));
+    }
+}
+
+namespace {
+
+/**
+ * @brief Bounds checked reader of a single record
+ */
+class RecordReader {
+public:
+    RecordReader(const char* pos, const char* end)
+            : mPos(pos),
+              mEnd(end) {
+    }
+
+    bool empty() const {
+        return mPos == mEnd;
+    }
+
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, advance(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string readString() {
+        auto length = read<uint32_t>();
+        auto data = advance(length);
+        return std::string(data, length);
+    }
+
+private:
+    const char* advance(size_t length) {
+        if (static_cast<size_t>(mEnd - mPos) < length) {
+            throw std::runtime_error("Corrupted binary log record");
+        }
+        auto pos = mPos;
+        mPos += length;
+        return pos;
+    }
+
+    const char* mPos;
+    const char* mEnd;
+};
+
+} // anonymous namespace
+
+bool BinaryLogReader::next(BinaryLogEntry& entry) {
+    using namespace impl::binary;
+    while (true) {
+        if (mData.size() - mOffset < RECORD_HEADER_SIZE) {
+            return false;
+        }
+        auto header = readRecordHeader(mData.data() + mOffset);
+        if (header.size == 0) {
+            return false;
+        }
+        if (header.size < RECORD_HEADER_SIZE || header.size > mData.size() - mOffset) {
+            throw std::runtime_error("Corrupted binary log record");
+        }
+        RecordReader reader(mData.data() + mOffset + RECORD_HEADER_SIZE, mData.data() + mOffset + header.size);
+        mOffset += header.size;
+
+        if (header.kind == RecordKind::SITE) {
+            Site site;
+            site.level = header.level;
+            site.line = reader.read<uint32_t>();
+            site.file = reader.readString();
+            site.function = reader.readString();
+            site.format = reader.readString();
+            if (header.site >= mSites.size()) {
+                mSites.resize(header.site + 1);
+            }
+            mSites[header.site] = std::move(site);
+            continue;
+        }
+        if (header.kind != RecordKind::LOG || header.site >= mSites.size() || mSites[header.site].file.empty()) {
+            throw std::runtime_error("Corrupted binary log record");
+        }
+
+        // Decode the arguments into their text representation
+        std::vector<std::string> values;
+        while (!reader.empty()) {
+            std::string value;
+            switch (reader.read<ArgumentType>()) {
+            case ArgumentType::INT:
+                impl::appendSigned(value, reader.read<int64_t>());
+                break;
+            case ArgumentType::UINT:
+                impl::appendUnsigned(value, reader.read<uint64_t>());
+                break;
+            case ArgumentType::DOUBLE:
+                impl::appendDouble(value, reader.read<double>());
+                break;
+            case ArgumentType::STRING:
+                value = reader.readString();
+                break;
+            case ArgumentType::CHAR:
+                value.push_back(reader.read<char>());
+                break;
+            case ArgumentType::BOOL:
+                value.push_back(reader.read<uint8_t>() ? '1' : '0');
+                break;
+            case ArgumentType::POINTER:
+                impl::appendPointer(value, reinterpret_cast<const void*>(
+                        static_cast<uintptr_t>(reader.read<uint64_t>())));
+                break;
+            default:
+                throw std::runtime_error("Corrupted binary log record");
+            }
+            values.emplace_back(std::move(value));
+        }
+        std::vector<impl::FormatArgument> arguments;
+        arguments.reserve(values.size());
+        for (auto& value : values) {
+            arguments.push_back(impl::FormatArgument{&value, &impl::appendArgument<std::string>});
+        }
+
+        auto& site = mSites[header.site];
+        entry.level = header.level;
+        auto elapsed = static_cast<double>(static_cast<int64_t>(header.timestamp - mHeader.timestamp))
+                / mHeader.ticksPerNanosecond;
+        entry.time = mHeader.realtime + static_cast<int64_t>(elapsed);
+        entry.file = site.file.c_str();
+        entry.line = site.line;
+        entry.function = site.function.c_str();
+        entry.message.clear();
+        impl::formatArguments(entry.message, site.format.c_str(), arguments.data(), arguments.size());
+        return true;
+    }
+}
+
+} // namespace logger
+} // namespace crossbow
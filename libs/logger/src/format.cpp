@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger/format.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <streambuf>
+
+namespace crossbow {
+namespace logger {
+namespace impl {
+
+const char gDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+namespace {
+
+/**
+ * @brief Stream buffer appending to a string
+ */
+class StringBuffer : public std::streambuf {
+public:
+    StringBuffer()
+            : mOut(nullptr) {
+    }
+
+    void reset(std::string& out) {
+        mOut = &out;
+    }
+
+protected:
+    virtual int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) {
+            mOut->push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char_type* s, std::streamsize n) override {
+        mOut->append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+private:
+    std::string* mOut;
+};
+
+struct ThreadStream {
+    ThreadStream()
+            : stream(&buffer) {
+    }
+
+    StringBuffer buffer;
+    std::ostream stream;
+};
+
+thread_local ThreadStream gThreadStream;
+
+thread_local std::string gThreadBuffer;
+
+} // anonymous namespace
+
+void appendDouble(std::string& out, double value) {
+    // Integral values are common and printed identically by %g as long as they have at most 6 digits
+    if (value > -1e6 && value < 1e6 && value == static_cast<double>(static_cast<int64_t>(value))
+            && !(value == 0.0 && std::signbit(value))) {
+        appendSigned(out, static_cast<int64_t>(value));
+        return;
+    }
+    char buffer[32];
+    auto length = snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+void appendLongDouble(std::string& out, long double value) {
+    char buffer[64];
+    auto length = snprintf(buffer, sizeof(buffer), "%Lg", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+void appendPointer(std::string& out, const void* value) {
+    auto address = reinterpret_cast<uintptr_t>(value);
+    if (address == 0) {
+        out.push_back('0');
+        return;
+    }
+    char buffer[2 + 2 * sizeof(uintptr_t)];
+    auto end = buffer + sizeof(buffer);
+    auto pos = end;
+    while (address != 0) {
+        *--pos = "0123456789abcdef"[address & 0xF];
+        address >>= 4;
+    }
+    *--pos = 'x';
+    *--pos = '0';
+    out.append(pos, static_cast<size_t>(end - pos));
+}
+
+std::ostream& stringStream(std::string& out) {
+    auto& local = gThreadStream;
+    local.buffer.reset(out);
+    local.stream.clear();
+    local.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    local.stream.precision(6);
+    local.stream.width(0);
+    local.stream.fill(' ');
+    return local.stream;
+}
+
+void formatArguments(std::string& out, const char* format, const FormatArgument* args, size_t numArgs) {
+    auto pos = format;
+    while (true) {
+        auto begin = pos;
+        while (*pos != '\0' && *pos != '%') {
+            ++pos;
+        }
+        out.append(begin, static_cast<size_t>(pos - begin));
+        if (*pos == '\0') {
+            return;
+        }
+
+        // Parse the placeholder
+        auto placeholder = pos++;
+        if (*pos == '%') {
+            out.push_back('%');
+            ++pos;
+            continue;
+        }
+        size_t index = 0;
+        while (*pos >= '0' && *pos <= '9') {
+            index = index * 10 + static_cast<size_t>(*pos - '0');
+            ++pos;
+        }
+        if (*pos != '%' || pos == placeholder + 1 || index == 0 || index > numArgs) {
+            // Invalid placeholders are copied verbatim
+            pos = placeholder + 1;
+            out.push_back('%');
+            continue;
+        }
+        ++pos;
+        args[index - 1].append(out, args[index - 1].value);
+    }
+}
+
+std::string& threadBuffer() {
+    return gThreadBuffer;
+}
+
+} // namespace impl
+} // namespace logger
+} // namespace crossbow
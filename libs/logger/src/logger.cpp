@@ -22,6 +22,9 @@
  */
 #include <crossbow/logger.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <unordered_map>
 
 namespace crossbow {
@@ -38,19 +41,358 @@ const std::unordered_map<crossbow::string, LogLevel> gLogLevelNames = {
     std::make_pair(crossbow::string("FATAL"), LogLevel::FATAL)
 };
 
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void writeStream(std::ostream& stream, const std::string& out) {
+    stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+    stream.flush();
+}
+
 } // anonymous namespace
 
+namespace impl {
+
+void appendLocation(std::string& out, const char* file, unsigned line, const char* function) {
+    out.append(" (in ");
+    out.append(function);
+    out.append(" at ");
+    out.append(file);
+    out.push_back(':');
+    out.append(std::to_string(line));
+    out.append(")\n");
+}
+
+LogRing::LogRing(size_t capacity)
+        : closed(false),
+          dropped(0),
+          mCapacity(roundUpPowerOfTwo(std::max(capacity, 4 * RECORD_ALIGNMENT))),
+          // new[] returns memory aligned to at least 16 bytes
+          mBuffer(new char[mCapacity]),
+          mHead(0),
+          mTail(0),
+          mCachedHead(0),
+          mReserved(0) {
+}
+
+LogRing::~LogRing() {
+    std::string discard;
+    consume([&discard](const RecordHeader& header, void* record) {
+        discard.clear();
+        header.process(record, discard);
+    });
+}
+
+/**
+ * @brief Background thread of the asynchronous logger
+ */
+class AsyncBackend {
+public:
+    AsyncBackend(LoggerT& logger, size_t ringSize, OverflowPolicy policy, uint64_t generation)
+            : mLogger(logger),
+              mRingSize(ringSize),
+              mPolicy(policy),
+              mGeneration(generation),
+              mRunning(true),
+              mThread(&AsyncBackend::run, this) {
+    }
+
+    ~AsyncBackend() {
+        stop();
+    }
+
+    uint64_t generation() const {
+        return mGeneration;
+    }
+
+    OverflowPolicy policy() const {
+        return mPolicy;
+    }
+
+    bool running() const {
+        return mRunning.load(std::memory_order_acquire);
+    }
+
+    std::shared_ptr<LogRing> registerRing() {
+        auto ring = std::make_shared<LogRing>(mRingSize);
+        std::lock_guard<std::mutex> _(mMutex);
+        mRings.push_back(ring);
+        return ring;
+    }
+
+    void wakeup() {
+        mCondition.notify_one();
+    }
+
+    /**
+     * @brief Stops the background thread after it wrote all pending records
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> _(mMutex);
+            if (!mRunning.load(std::memory_order_relaxed)) {
+                return;
+            }
+            mRunning.store(false, std::memory_order_release);
+        }
+        mCondition.notify_one();
+        mThread.join();
+    }
+
+    /**
+     * @brief Writes the records committed after the backend was stopped and releases the rings of terminated threads
+     *
+     * Must only be called after stop().
+     */
+    void collect() {
+        drain();
+    }
+
+private:
+    void run();
+
+    size_t drain();
+
+    LoggerT& mLogger;
+    size_t mRingSize;
+    OverflowPolicy mPolicy;
+    uint64_t mGeneration;
+
+    std::atomic<bool> mRunning;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::vector<std::shared_ptr<LogRing>> mRings;
+
+    std::thread mThread;
+};
+
+void AsyncBackend::run() {
+    while (true) {
+        if (drain() != 0) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (!mRunning.load(std::memory_order_relaxed)) {
+            break;
+        }
+        mCondition.wait_for(lock, std::chrono::milliseconds(1));
+    }
+
+    // Write the records logged before the logger was stopped
+    drain();
+}
+
+size_t AsyncBackend::drain() {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> _(mMutex);
+        rings = mRings;
+    }
+
+    // Batch the output of all rings per stream
+    struct Batch {
+        std::ostream* stream;
+        std::string out;
+    };
+    std::vector<Batch> batches;
+    auto batch = [this, &batches](LogLevel level) -> std::string& {
+        auto stream = &mLogger.levelStream(level);
+        for (auto& b : batches) {
+            if (b.stream == stream) {
+                return b.out;
+            }
+        }
+        batches.push_back(Batch{stream, std::string()});
+        return batches.back().out;
+    };
+
+    size_t count = 0;
+    for (auto& ring : rings) {
+        auto closed = ring->closed.load(std::memory_order_acquire);
+        count += ring->consume([&batch](const RecordHeader& header, void* record) {
+            header.process(record, batch(header.level));
+        });
+        if (auto dropped = ring->dropped.exchange(0)) {
+            auto& out = batch(LogLevel::WARN);
+            out.append("Dropped ");
+            out.append(std::to_string(dropped));
+            out.append(" log records as the logging thread was too fast\n");
+        }
+        if (closed) {
+            std::lock_guard<std::mutex> _(mMutex);
+            mRings.erase(std::find(mRings.begin(), mRings.end(), ring));
+        }
+    }
+
+    // Records too large for the rings and records of a stopped logger are written synchronously at the same time
+    for (auto& b : batches) {
+        std::lock_guard<std::mutex> _(mLogger.streamMutex(*b.stream));
+        writeStream(*b.stream, b.out);
+    }
+    return count;
+}
+
+} // namespace impl
+
+namespace {
+
+std::atomic<uint64_t> gAsyncGeneration(0);
+
+/**
+ * @brief Ring buffer of the current thread
+ *
+ * Marks the ring as closed when the thread terminates so the background thread can release it once it is drained.
+ */
+struct ThreadRing {
+    uint64_t generation = 0;
+    std::shared_ptr<impl::LogRing> ring;
+
+    ~ThreadRing() {
+        if (ring) {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadRing gThreadRing;
+
+} // anonymous namespace
+
+namespace impl {
+
+std::atomic<LogLevel> gLogLevel(LogLevel::TRACE);
+
+} // namespace impl
+
 Logger logger;
 
+LoggerT::LoggerT()
+        : mAsync(nullptr),
+          mBinarySink(nullptr) {
+}
+
 LoggerT::~LoggerT() {
+    stopAsync();
+    for (auto& backend : mBackends) {
+        backend->collect();
+    }
+    mBinarySink.store(nullptr);
+    mBinarySinks.clear();
     for (auto& fun : config.destructFunctions) {
         fun();
     }
 }
 
+void LoggerT::startAsync(size_t ringSize, OverflowPolicy policy) {
+    std::lock_guard<std::mutex> _(mAsyncMutex);
+    if (mAsync.load()) {
+        return;
+    }
+    for (auto& backend : mBackends) {
+        backend->collect();
+    }
+    mBackends.emplace_back(new impl::AsyncBackend(*this, ringSize, policy, ++gAsyncGeneration));
+    mAsync.store(mBackends.back().get(), std::memory_order_release);
+}
+
+void LoggerT::stopAsync() {
+    std::lock_guard<std::mutex> _(mAsyncMutex);
+    if (!mAsync.load()) {
+        return;
+    }
+    mAsync.store(nullptr, std::memory_order_release);
+    mBackends.back()->stop();
+}
+
+impl::LogRing& LoggerT::threadRing(impl::AsyncBackend* backend) {
+    auto& local = gThreadRing;
+    if (local.generation != backend->generation()) {
+        if (local.ring) {
+            local.ring->closed.store(true, std::memory_order_release);
+        }
+        local.ring = backend->registerRing();
+        local.generation = backend->generation();
+    }
+    return *local.ring;
+}
+
+bool LoggerT::waitForSpace(impl::AsyncBackend* backend, impl::LogRing& ring) {
+    if (backend->policy() == OverflowPolicy::DROP || !backend->running()) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    backend->wakeup();
+    std::this_thread::yield();
+    return true;
+}
+
+void LoggerT::writeSync(LogLevel level, const std::string& out) {
+    auto& stream = levelStream(level);
+    std::lock_guard<std::mutex> _(streamMutex(stream));
+    writeStream(stream, out);
+}
+
+void LoggerT::setBinarySink(std::shared_ptr<BinaryLogSink> sink) {
+    std::lock_guard<std::mutex> _(mAsyncMutex);
+    mBinarySink.store(sink.get(), std::memory_order_release);
+    if (sink) {
+        mBinarySinks.emplace_back(std::move(sink));
+    }
+}
+
+std::ostream& LoggerT::levelStream(LogLevel level) {
+    switch (level) {
+    case LogLevel::TRACE:
+        return *config.traceOut;
+    case LogLevel::DEBUG:
+        return *config.debugOut;
+    case LogLevel::INFO:
+        return *config.infoOut;
+    case LogLevel::WARN:
+        return *config.warnOut;
+    case LogLevel::ERROR:
+        return *config.errorOut;
+    default:
+        return *config.fatalOut;
+    }
+}
+
+std::mutex& LoggerT::streamMutex(const std::ostream& stream) {
+    if (&stream == &std::cout) {
+        return mStdoutMutex;
+    }
+    if (&stream == &std::cerr || &stream == &std::clog) {
+        return mStderrMutex;
+    }
+    return mOtherMutex;
+}
+
 LogLevel logLevelFromString(const crossbow::string& s) {
     return gLogLevelNames.at(s);
 }
 
+const char* logLevelToString(LogLevel level) {
+    switch (level) {
+    case LogLevel::TRACE:
+        return "TRACE";
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::WARN:
+        return "WARN";
+    case LogLevel::ERROR:
+        return "ERROR";
+    default:
+        return "FATAL";
+    }
+}
+
 } // namespace logger
 } // namespace crossbow
@@ -0,0 +1,105 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger.hpp>
+#include <crossbow/program_options.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace crossbow::program_options;
+
+namespace {
+
+void printTime(std::string& out, int64_t time) {
+    auto seconds = static_cast<time_t>(time / 1000000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char buffer[64];
+    auto length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    length += static_cast<size_t>(snprintf(buffer + length, sizeof(buffer) - length, ".%09lld",
+            static_cast<long long>(time % 1000000000)));
+    out.append(buffer, length);
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Decodes binary log files written by crossbow::logger::BinaryLogSink into text
+ */
+int main(int argc, const char** argv) {
+    crossbow::string level("TRACE");
+    bool help = false;
+    auto opts = create_options("crossbow_logdecode",
+            value<'h'>("help", &help, tag::description{"Print help"}),
+            value<'l'>("level", &level, tag::description{"Minimum level of the printed records"}));
+
+    int files;
+    try {
+        files = parse(opts, argc, argv);
+    } catch (const crossbow::program_options::parse_error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        print_help(std::cout, opts);
+        return 1;
+    }
+    if (help || files >= argc) {
+        print_help(std::cout, opts);
+        std::cout << " file..." << std::endl << "    Binary log files to decode" << std::endl;
+        return help ? 0 : 1;
+    }
+
+    crossbow::logger::LogLevel minLevel;
+    try {
+        minLevel = crossbow::logger::logLevelFromString(level);
+    } catch (const std::out_of_range&) {
+        std::cerr << "Unknown log level " << level << std::endl;
+        return 1;
+    }
+
+    std::string out;
+    for (auto i = files; i < argc; ++i) {
+        try {
+            crossbow::logger::BinaryLogReader reader(argv[i]);
+            crossbow::logger::BinaryLogEntry entry;
+            while (reader.next(entry)) {
+                if (entry.level < minLevel) {
+                    continue;
+                }
+                out.clear();
+                printTime(out, entry.time);
+                out.push_back(' ');
+                out.append(crossbow::logger::logLevelToString(entry.level));
+                out.push_back(' ');
+                out.append(entry.message);
+                crossbow::logger::impl::appendLocation(out, entry.file, entry.line, entry.function);
+                std::cout << out;
+            }
+        } catch (const std::runtime_error& e) {
+            std::cerr << argv[i] << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/ChunkAllocator.hpp>
+#include <crossbow/Serializer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+using namespace crossbow;
+
+namespace {
+
+const char* gLong = "a string that is too long for the small string buffer";
+
+/**
+ * @brief Returns true if p points into memory handed out by the pool
+ *
+ * The pool is a bump allocator, so the next allocation directly follows everything allocated so far.
+ */
+bool fromPool(ChunkMemoryPool& pool, const char* p) {
+    auto next = static_cast<const char*>(pool.allocate(1));
+    return p < next && next - p < static_cast<std::ptrdiff_t>(pool.chunkSize());
+}
+
+void testConstruction(ChunkMemoryPool& pool) {
+    ChunkAllocator<char> alloc(&pool);
+    arena_string small("short", alloc);
+    assert(small == "short");
+    assert(small.get_allocator() == alloc);
+
+    arena_string str(gLong, alloc);
+    assert(str == gLong);
+    assert(fromPool(pool, str.data()));
+
+    // Copies share the pool of the original
+    arena_string copy(str);
+    assert(copy == gLong);
+    assert(copy.get_allocator() == alloc);
+    assert(fromPool(pool, copy.data()));
+
+    arena_string sub = str.substr(2, 40);
+    assert(sub == std::string(gLong).substr(2, 40).c_str());
+    assert(sub.get_allocator() == alloc);
+}
+
+void testPropagation(ChunkMemoryPool& pool1, ChunkMemoryPool& pool2) {
+    ChunkAllocator<char> alloc1(&pool1);
+    ChunkAllocator<char> alloc2(&pool2);
+
+    // Assignment keeps the pool of the target
+    arena_string str1(gLong, alloc1);
+    arena_string str2("", alloc2);
+    str2 = str1;
+    assert(str2 == gLong);
+    assert(str2.get_allocator() == alloc2);
+    assert(fromPool(pool2, str2.data()));
+
+    // Moving between different pools copies the characters
+    arena_string str3("", alloc2);
+    auto data = str1.data();
+    str3 = std::move(str1);
+    assert(str3 == gLong);
+    assert(str3.get_allocator() == alloc2);
+    assert(str3.data() != data);
+
+    // Moving within a pool takes over the buffer
+    arena_string str4(gLong, alloc2);
+    data = str4.data();
+    arena_string str5("", alloc2);
+    str5 = std::move(str4);
+    assert(str5.data() == data);
+    assert(str4.empty());
+
+    // Allocator extended move constructor
+    arena_string str6(std::move(str5), alloc2);
+    assert(str6.data() == data);
+    arena_string str7(std::move(str6), alloc1);
+    assert(str7 == gLong);
+    assert(str7.get_allocator() == alloc1);
+    assert(fromPool(pool1, str7.data()));
+
+    // Allocator extended copy constructor
+    arena_string str8(str7, alloc2);
+    assert(str8 == gLong);
+    assert(fromPool(pool2, str8.data()));
+}
+
+void testContainers(ChunkMemoryPool& pool) {
+    arena_vector<arena_string> values{ChunkAllocator<arena_string>(&pool)};
+    arena_unordered_map<arena_string, std::size_t> index(16, std::hash<arena_string>(), std::equal_to<arena_string>(),
+            ChunkAllocator<std::pair<const arena_string, std::size_t>>(&pool));
+    for (std::size_t i = 0; i < 1000; ++i) {
+        arena_string key{ChunkAllocator<char>(&pool)};
+        key.append("a key that lives in the request pool ");
+        key.append(std::to_string(i).c_str());
+        index.emplace(key, i);
+        values.emplace_back(std::move(key));
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        assert(index.at(values[i]) == i);
+    }
+}
+
+void testDeserialize(ChunkMemoryPool& pool) {
+    crossbow::string in(gLong);
+    sizer s;
+    s & in;
+    serializer ser(s.size);
+    ser & in;
+
+    arena_string out{ChunkAllocator<char>(&pool)};
+    deserializer des(ser.buffer.get());
+    des & out;
+    assert(out == gLong);
+    assert(fromPool(pool, out.data()));
+}
+
+} // anonymous namespace
+
+int main() {
+    ChunkMemoryPool pool1;
+    ChunkMemoryPool pool2;
+    testConstruction(pool1);
+    testPropagation(pool1, pool2);
+    testContainers(pool1);
+    testDeserialize(pool2);
+}
@@ -0,0 +1,198 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/infinio/EventProcessor.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace crossbow::infinio;
+
+namespace {
+
+constexpr int64_t US = 1000;
+
+IdleConfig testConfig() {
+    IdleConfig config(100000);
+    config.maxSpinTime = std::chrono::microseconds(400);
+    config.minSpinTime = std::chrono::microseconds(25);
+    config.maxPauses = 8;
+    config.yieldRounds = 4;
+    config.growWindow = std::chrono::microseconds(100);
+    config.sleepTimeout = std::chrono::milliseconds(10);
+    return config;
+}
+
+/**
+ * Idles starting at the given time with one round per microsecond until the policy decides to sleep
+ *
+ * @return The time the policy decided to sleep
+ */
+int64_t idleUntilSleep(IdlePolicy& policy, int64_t now) {
+    while (policy.idle(now) != IdlePolicy::Action::SLEEP) {
+        now += US;
+    }
+    return now;
+}
+
+/**
+ * The spin phase ends once the time budget elapsed, the pause count grows exponentially
+ */
+void testSpinPhase() {
+    IdlePolicy policy(testConfig());
+    assert(policy.budget() == 400 * US);
+
+    int64_t now = 1000 * US;
+    uint32_t expectedPauses = 1;
+    for (int64_t i = 0; i < 400; ++i) {
+        assert(policy.idle(now + i * US) == IdlePolicy::Action::SPIN);
+        assert(policy.pauses() == expectedPauses);
+        expectedPauses = std::min(expectedPauses * 2, 8u);
+    }
+    for (int i = 0; i < 4; ++i) {
+        assert(policy.idle(now + 400 * US) == IdlePolicy::Action::YIELD);
+    }
+    assert(policy.idle(now + 401 * US) == IdlePolicy::Action::SLEEP);
+    assert(policy.spinNanos() == 400 * US);
+}
+
+/**
+ * The spin phase also ends after maxSpinRounds rounds
+ */
+void testRoundLimit() {
+    auto config = testConfig();
+    config.maxSpinRounds = 10;
+    IdlePolicy policy(config);
+    for (int i = 0; i < 10; ++i) {
+        assert(policy.idle(0) == IdlePolicy::Action::SPIN);
+    }
+    assert(policy.idle(0) == IdlePolicy::Action::YIELD);
+}
+
+/**
+ * Periodic events with gaps longer than the spin phase shrink the budget to the minimum
+ */
+void testShrinkOnLongGaps() {
+    IdlePolicy policy(testConfig());
+    int64_t now = 0;
+    for (int i = 0; i < 10; ++i) {
+        idleUntilSleep(policy, now);
+        now += 10000 * US;
+        policy.busy(now);
+    }
+    assert(policy.budget() == 25 * US);
+    assert(!policy.idling());
+}
+
+/**
+ * Events arriving shortly after the spin phase grow the budget up to the maximum
+ */
+void testGrowOnShortGaps() {
+    IdlePolicy policy(testConfig());
+    int64_t now = 0;
+    for (int i = 0; i < 10; ++i) {
+        idleUntilSleep(policy, now);
+        now += 10000 * US;
+        policy.busy(now);
+    }
+    assert(policy.budget() == 25 * US);
+
+    for (int i = 0; i < 10; ++i) {
+        auto sleep = idleUntilSleep(policy, now);
+        now = sleep + 50 * US;
+        policy.busy(now);
+    }
+    assert(policy.budget() == 400 * US);
+}
+
+/**
+ * Events caught while spinning leave the budget unchanged
+ */
+void testCaughtWhileSpinning() {
+    IdlePolicy policy(testConfig());
+    int64_t now = 0;
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 50; ++j) {
+            assert(policy.idle(now) == IdlePolicy::Action::SPIN);
+            now += US;
+        }
+        policy.busy(now);
+    }
+    assert(policy.budget() == 400 * US);
+    assert(policy.spinNanos() == 100 * 50 * US);
+}
+
+/**
+ * Pollers can not be deregistered while the event loop is running, the queue is not destroyed.
+ */
+TaskQueue& createQueue(EventProcessor& processor) {
+    return *(new TaskQueue(processor));
+}
+
+template <typename Fun>
+void waitFor(Fun fun) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!fun()) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+/**
+ * Tasks from another thread are executed and wake up the sleeping event processor
+ */
+void testTaskQueue() {
+    EventProcessor processor(testConfig());
+    auto& queue = createQueue(processor);
+    processor.start();
+
+    std::atomic<int> executed(0);
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        queue.execute([&executed] {
+            ++executed;
+        });
+        waitFor([&executed, i] {
+            return executed.load() == i + 1;
+        });
+    }
+
+    auto stats = processor.stats();
+    assert(stats.busyRounds >= 10);
+    assert(stats.sleeps > 0);
+    assert(stats.spinBudgetNanos >= 25 * US && stats.spinBudgetNanos <= 400 * US);
+    assert(stats.maxWakeupLatencyNanos <= stats.wakeupLatencyNanos);
+}
+
+} // anonymous namespace
+
+int main() {
+    testSpinPhase();
+    testRoundLimit();
+    testShrinkOnLongGaps();
+    testGrowOnShortGaps();
+    testCaughtWhileSpinning();
+    testTaskQueue();
+}
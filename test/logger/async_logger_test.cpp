@@ -0,0 +1,218 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::logger;
+
+namespace {
+
+constexpr size_t NUM_THREADS = 4;
+constexpr size_t NUM_RECORDS = 10000;
+
+std::vector<std::string> lines(const std::string& out) {
+    std::vector<std::string> res;
+    std::istringstream in(out);
+    std::string line;
+    while (std::getline(in, line)) {
+        res.push_back(line);
+    }
+    return res;
+}
+
+void testOrdering() {
+    std::ostringstream out;
+    logger->config.infoOut = &out;
+    logger->startAsync(4096, OverflowPolicy::BLOCK);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([t]() {
+            for (size_t i = 0; i < NUM_RECORDS; ++i) {
+                LOG_INFO("thread %1% record %2%", t, i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger->stopAsync();
+
+    // No record is lost and the records of every thread keep their order
+    auto res = lines(out.str());
+    assert(res.size() == NUM_THREADS * NUM_RECORDS);
+    std::vector<size_t> next(NUM_THREADS, 0);
+    for (auto& line : res) {
+        size_t t, i;
+        auto count = sscanf(line.c_str(), "thread %zu record %zu", &t, &i);
+        assert(count == 2);
+        assert(t < NUM_THREADS);
+        assert(next[t] == i);
+        ++next[t];
+    }
+}
+
+void testStringArguments() {
+    std::ostringstream out;
+    logger->config.infoOut = &out;
+    logger->startAsync(4096, OverflowPolicy::BLOCK);
+
+    // C strings are copied into the record
+    char buffer[16];
+    strcpy(buffer, "first");
+    LOG_INFO("value %1%", static_cast<const char*>(buffer));
+    strcpy(buffer, "second");
+    LOG_INFO("value %1%", static_cast<const char*>(buffer));
+
+    // Records larger than the ring are written synchronously
+    std::string large(8192, 'x');
+    LOG_INFO("large %1%", large);
+    logger->stopAsync();
+
+    auto res = lines(out.str());
+    assert(res.size() == 3);
+    assert(res[0].find("value first (in ") == 0);
+    assert(res[1].find("value second (in ") == 0);
+    assert(res[2].find("large " + large) == 0);
+}
+
+void testDrop() {
+    std::ostringstream out;
+    std::ostringstream warn;
+    logger->config.infoOut = &out;
+    logger->config.warnOut = &warn;
+    logger->startAsync(1024, OverflowPolicy::DROP);
+    for (size_t i = 0; i < NUM_RECORDS; ++i) {
+        LOG_INFO("record %1%", i);
+    }
+    logger->stopAsync();
+
+    auto res = lines(out.str());
+    assert(res.size() > 0 && res.size() <= NUM_RECORDS);
+    if (res.size() < NUM_RECORDS) {
+        assert(warn.str().find("Dropped ") == 0);
+    }
+}
+
+/**
+ * Restarting the logger while other threads are logging neither frees a backend still in use nor leaks the copied
+ * string arguments of records committed after the backend stopped
+ */
+void testRestart() {
+    std::ostringstream out;
+    logger->config.infoOut = &out;
+    logger->startAsync(4096, OverflowPolicy::BLOCK);
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&done]() {
+            std::string arg(64, 'a');
+            while (!done.load()) {
+                LOG_INFO("restart %1%", arg);
+            }
+        });
+    }
+    for (size_t i = 0; i < 50; ++i) {
+        logger->stopAsync();
+        logger->startAsync(4096, OverflowPolicy::BLOCK);
+    }
+    done.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    logger->stopAsync();
+
+    for (auto& line : lines(out.str())) {
+        assert(line.find("restart " + std::string(64, 'a')) == 0);
+    }
+}
+
+struct NonCopyable {
+    NonCopyable() = default;
+    NonCopyable(const NonCopyable&) = delete;
+    NonCopyable& operator=(const NonCopyable&) = delete;
+
+    int value = 42;
+};
+
+std::ostream& operator<<(std::ostream& out, const NonCopyable& obj) {
+    return out << "nc" << obj.value;
+}
+
+/**
+ * @brief Arguments that can not be stored in a record are formatted by the logging thread
+ */
+void testNonCopyableArguments() {
+    std::ostringstream out;
+    logger->config.infoOut = &out;
+    logger->startAsync(4096, OverflowPolicy::BLOCK);
+    NonCopyable obj;
+    LOG_INFO("value %1% %2%%%", obj, 1);
+    logger->stopAsync();
+
+    auto res = lines(out.str());
+    assert(res.size() == 1);
+    assert(res[0].find("value nc42 1% (in ") == 0);
+}
+
+/**
+ * @brief Records are written through the stream, honouring a redirected stream buffer
+ */
+void testRedirectedStream() {
+    std::ostringstream out;
+    auto buf = std::cout.rdbuf(out.rdbuf());
+    logger->config.infoOut = &std::cout;
+    logger->startAsync(4096, OverflowPolicy::BLOCK);
+    LOG_INFO("redirected %1%", 1);
+    logger->stopAsync();
+    std::cout.rdbuf(buf);
+
+    auto res = lines(out.str());
+    assert(res.size() == 1);
+    assert(res[0].find("redirected 1") == 0);
+}
+
+} // anonymous namespace
+
+int main() {
+    logger->config.level = LogLevel::TRACE;
+    testOrdering();
+    testStringArguments();
+    testDrop();
+    testRestart();
+    testNonCopyableArguments();
+    testRedirectedStream();
+
+    logger->config.infoOut = &std::cout;
+    logger->config.warnOut = &std::clog;
+    return 0;
+}
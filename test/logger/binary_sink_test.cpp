@@ -0,0 +1,211 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace crossbow::logger;
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& out, const Point& p) {
+    return out << '(' << p.x << ", " << p.y << ')';
+}
+
+enum Status {
+    FAILED = 2
+};
+
+enum class Color {
+    RED
+};
+
+std::ostream& operator<<(std::ostream& out, Color) {
+    return out << "red";
+}
+
+bool exists(const std::string& path) {
+    return ::access(path.c_str(), F_OK) == 0;
+}
+
+struct Entry {
+    LogLevel level;
+    int64_t time;
+    std::string file;
+    std::string function;
+    std::string message;
+};
+
+std::vector<Entry> readAll(const std::string& path) {
+    std::vector<Entry> entries;
+    BinaryLogReader reader(path);
+    BinaryLogEntry entry;
+    while (reader.next(entry)) {
+        entries.push_back(Entry{entry.level, entry.time, entry.file, entry.function, entry.message});
+    }
+    return entries;
+}
+
+int64_t now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Concurrent writers rotating through many small files
+ */
+void testConcurrentWriters(const std::string& path) {
+    constexpr int numThreads = 4;
+    constexpr int numRecords = 5000;
+    auto sink = std::make_shared<BinaryLogSink>(path, 4096, 0);
+    logger->setBinarySink(sink);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t] () {
+            for (int i = 0; i < numRecords; ++i) {
+                BINLOG_TRACE("thread %1% record %2%", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger->setBinarySink(nullptr);
+    assert(sink->dropped() == 0);
+    auto last = std::stoul(sink->currentFile().substr(path.size() + 1));
+    sink.reset();
+
+    // Every record is written exactly once and the records of a thread keep their order
+    std::vector<int> next(numThreads, 0);
+    for (unsigned long i = 1; i <= last; ++i) {
+        auto file = path + "." + std::to_string(i);
+        for (auto& entry : readAll(file)) {
+            int t, r;
+            assert(sscanf(entry.message.c_str(), "thread %d record %d", &t, &r) == 2);
+            assert(t >= 0 && t < numThreads);
+            assert(r == next[t]);
+            ++next[t];
+        }
+        ::unlink(file.c_str());
+    }
+    for (auto n : next) {
+        assert(n == numRecords);
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    char dir[] = "/tmp/crossbow_binlogXXXXXX";
+    assert(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/trace";
+
+    std::ostringstream text;
+    logger->config.traceOut = &text;
+    logger->config.level = LogLevel::TRACE;
+
+    // Without a sink the statements are logged as text
+    BINLOG_TRACE("text %1%", 1);
+    assert(text.str().find("text 1 (in ") == 0);
+
+    auto begin = now();
+    auto sink = std::make_shared<BinaryLogSink>(path, 4096, 2);
+    logger->setBinarySink(sink);
+    assert(sink->currentFile() == path + ".1");
+
+    int value = 0;
+    const char* cstr = "cstr";
+    BINLOG_TRACE("ints %1% %2% %3%", -1, 2u, static_cast<uint64_t>(1) << 63);
+    BINLOG_INFO("floats %1% %2%", 0.5, 1.0f / 3.0f);
+    BINLOG_DEBUG("strings %1% %2% %3% %4%", cstr, std::string("std"), crossbow::string("crossbow"), "literal");
+    BINLOG_WARN("misc %1% %2% %3% %4% %5% %6%", 'c', true, FAILED, Color::RED, Point{1, 2}, &value);
+    BINLOG_ERROR("no arguments, 100%%");
+
+    auto entries = readAll(path + ".1");
+    assert(entries.size() == 5);
+    assert(entries[0].message == "ints -1 2 9223372036854775808");
+    assert(entries[0].level == LogLevel::TRACE);
+    assert(entries[1].message == "floats 0.5 0.333333");
+    assert(entries[1].level == LogLevel::INFO);
+    assert(entries[2].message == "strings cstr std crossbow literal");
+    std::ostringstream pointer;
+    pointer << static_cast<const void*>(&value);
+    assert(entries[3].message == "misc c 1 2 red (1, 2) " + pointer.str());
+    assert(entries[4].message == "no arguments, 100%");
+    assert(entries[4].level == LogLevel::ERROR);
+    assert(entries[0].function == "main");
+    assert(entries[0].file == __FILE__);
+    for (auto& entry : entries) {
+        // The timestamp counter is calibrated, allow for some skew
+        assert(entry.time > begin - 1000000000 && entry.time < now() + 1000000000);
+    }
+
+    // Call sites are defined again in every file after rotating
+    for (int i = 0; i < 1000; ++i) {
+        BINLOG_TRACE("record %1%", i);
+    }
+    assert(sink->dropped() == 0);
+    assert(sink->currentFile() != path + ".1");
+    assert(!exists(path + ".1"));
+    auto last = readAll(sink->currentFile());
+    assert(!last.empty());
+    assert(last.back().message == "record 999");
+
+    // Disabled levels are not written
+    logger->config.level = LogLevel::INFO;
+    BINLOG_TRACE("disabled");
+    logger->config.level = LogLevel::TRACE;
+    assert(readAll(sink->currentFile()).back().message == "record 999");
+
+    logger->setBinarySink(nullptr);
+    logger->config.traceOut = &std::cout;
+    assert(text.str().find("record") == std::string::npos);
+
+    auto current = sink->currentFile();
+    sink.reset();
+    ::unlink(current.c_str());
+    for (int i = 1; i < 100; ++i) {
+        ::unlink((path + "." + std::to_string(i)).c_str());
+    }
+
+    testConcurrentWriters(std::string(dir) + "/concurrent");
+    ::rmdir(dir);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#define CROSSBOW_LOG_CHECK_FORMAT
+#include <crossbow/logger.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+using namespace crossbow::logger;
+
+namespace {
+
+enum Color {
+    RED = 3
+};
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& out, const Point& p) {
+    return out << std::hex << '(' << p.x << ", " << p.y << ')';
+}
+
+template<class... Args>
+std::string format(const char* str, const Args&... args) {
+    std::string out;
+    impl::format(out, str, args...);
+    return out;
+}
+
+template<class T>
+std::string streamed(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+static_assert(impl::checkFormat("no placeholder", 0), "Format without placeholders");
+static_assert(impl::checkFormat("%1% and %2%", 2), "Valid placeholders");
+static_assert(impl::checkFormat("100%% of %1%", 1), "Escaped percent");
+static_assert(!impl::checkFormat("%1% and %2%", 1), "Too few arguments");
+static_assert(!impl::checkFormat("%0%", 1), "Placeholders start at 1");
+static_assert(!impl::checkFormat("%1", 1), "Unterminated placeholder");
+static_assert(!impl::checkFormat("%s", 1), "Unsupported directive");
+
+} // anonymous namespace
+
+int main() {
+    // Integers
+    assert(format("%1%", 0) == "0");
+    assert(format("%1% %2%", -42, 42u) == "-42 42");
+    assert(format("%1%", std::numeric_limits<int64_t>::min()) == streamed(std::numeric_limits<int64_t>::min()));
+    assert(format("%1%", std::numeric_limits<uint64_t>::max()) == streamed(std::numeric_limits<uint64_t>::max()));
+    assert(format("%1%", static_cast<short>(-7)) == "-7");
+
+    // Characters and booleans are printed like std::ostream does
+    assert(format("%1%%2%", 'a', true) == "a1");
+
+    // Floating point numbers
+    double values[] = {0.0, -0.0, 1.0, -3.0, 0.5, 1.0 / 3.0, 123456.0, 1234567.0, 1e-10, 6.02e23};
+    for (auto v : values) {
+        assert(format("%1%", v) == streamed(v));
+    }
+    assert(format("%1%", 2.5f) == "2.5");
+
+    // Strings and pointers
+    const char* cstr = "cstr";
+    assert(format("%1% %2% %3% %4%", cstr, std::string("std"), crossbow::string("crossbow"), "literal")
+            == "cstr std crossbow literal");
+    int i = 0;
+    assert(format("%1%", &i) == streamed(static_cast<const void*>(&i)));
+
+    // Other types use their stream operator with default flags
+    assert(format("%1% %2%", Point{10, 11}, Point{10, 11}) == "(a, b) (a, b)");
+    assert(format("%1%", RED) == "3");
+    assert(format("%1%", std::make_error_code(std::errc::invalid_argument))
+            == streamed(std::make_error_code(std::errc::invalid_argument)));
+
+    // Placeholders
+    assert(format("%2% %1% %2%", 1, 2) == "2 1 2");
+    assert(format("100%% %1%", 1) == "100% 1");
+    assert(format("%3% %1 %x% %", 1) == "%3% %1 %x% %");
+    assert(format("%1%", 1, 2) == "1");
+
+    // The logging macros check the format at compile time
+    std::ostringstream out;
+    logger->config.infoOut = &out;
+    LOG_INFO("checked %1% %2%", 1, "two");
+    LOG_INFO("no arguments");
+    logger->config.infoOut = &std::cout;
+    assert(out.str().find("checked 1 two (in ") == 0);
+    assert(out.str().find("no arguments (in ") != std::string::npos);
+    return 0;
+}
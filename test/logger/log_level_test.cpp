@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#define CROSSBOW_LOG_MIN_LEVEL 1
+#include <crossbow/logger.hpp>
+
+#include <cassert>
+#include <sstream>
+#include <string>
+
+using namespace crossbow::logger;
+
+namespace {
+
+int gEvaluated = 0;
+
+int evaluate() {
+    return ++gEvaluated;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::ostringstream out;
+    logger->config.traceOut = &out;
+    logger->config.debugOut = &out;
+    logger->config.infoOut = &out;
+    logger->config.warnOut = &out;
+
+    // Levels below the compile time minimum are removed
+    logger->config.level = LogLevel::TRACE;
+    LOG_TRACE("trace %1%", evaluate());
+    assert(gEvaluated == 0);
+    assert(out.str().empty());
+
+    LOG_DEBUG("debug %1%", evaluate());
+    assert(gEvaluated == 1);
+
+    // Arguments of disabled levels are not evaluated
+    logger->config.level = LogLevel::WARN;
+    assert(logger->config.level == LogLevel::WARN);
+    assert(!isEnabled(LogLevel::INFO));
+    LOG_DEBUG("debug %1%", evaluate());
+    LOG_INFO("info %1%", evaluate());
+    assert(gEvaluated == 1);
+
+    LOG_WARN("warn %1%", evaluate());
+    assert(gEvaluated == 2);
+
+    // The macros are usable as single statements
+    if (gEvaluated == 2)
+        LOG_WARN("format %1%", std::string("string"));
+    else
+        LOG_WARN("unreachable");
+
+    auto str = out.str();
+    assert(str.find("debug 1 (in ") == 0);
+    assert(str.find("warn 2 (in ") != std::string::npos);
+    assert(str.find("format string (in ") != std::string::npos);
+    assert(str.find("unreachable") == std::string::npos);
+
+    // Formats that are not literals
+    std::string format("dynamic %1%");
+    logger->warn(__FILE__, __LINE__, __FUNCTION__, format, 3);
+    logger->warn(__FILE__, __LINE__, __FUNCTION__, crossbow::string("crossbow %1%"), 4);
+    logger->startAsync();
+    logger->warn(__FILE__, __LINE__, __FUNCTION__, format, 5);
+    logger->stopAsync();
+    str = out.str();
+    assert(str.find("dynamic 3 (in ") != std::string::npos);
+    assert(str.find("crossbow 4 (in ") != std::string::npos);
+    assert(str.find("dynamic 5 (in ") != std::string::npos);
+
+    logger->config.traceOut = &std::cout;
+    logger->config.debugOut = &std::cout;
+    logger->config.infoOut = &std::cout;
+    logger->config.warnOut = &std::clog;
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/logger.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace crossbow::logger;
+
+namespace {
+
+std::vector<std::string> lines(std::ostringstream& out) {
+    std::vector<std::string> res;
+    std::istringstream in(out.str());
+    std::string line;
+    while (std::getline(in, line)) {
+        res.push_back(line);
+    }
+    out.str(std::string());
+    return res;
+}
+
+void testEveryN(std::ostringstream& out) {
+    for (int i = 0; i < 100; ++i) {
+        LOG_WARN_EVERY_N(10, "every n %1%", i);
+    }
+    auto res = lines(out);
+    assert(res.size() == 10);
+    assert(res[0].find("every n 0 (in ") == 0);
+    assert(res[1].find("every n 10 [9 similar messages suppressed] (in ") == 0);
+
+    // The state is shared between all threads logging from the statement
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; ++i) {
+                LOG_WARN_EVERY_N(100, "threads");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    assert(lines(out).size() == 40);
+}
+
+void testEveryMs(std::ostringstream& out) {
+    auto log = [](int i) {
+        LOG_WARN_EVERY_MS(200, "every ms %1%", i);
+    };
+    for (int i = 0; i < 100; ++i) {
+        log(i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    log(100);
+    auto res = lines(out);
+    assert(res.size() == 2);
+    assert(res[0].find("every ms 0 (in ") == 0);
+    assert(res[1].find("every ms 100 [99 similar messages suppressed] (in ") == 0);
+}
+
+void testRate(std::ostringstream& out) {
+    auto log = [](int i) {
+        LOG_WARN_RATE(10, 5, "rate %1%", i);
+    };
+    // The burst is logged right away
+    for (int i = 0; i < 100; ++i) {
+        log(i);
+    }
+    auto res = lines(out);
+    assert(res.size() >= 5 && res.size() <= 6);
+    assert(res[4].find("rate 4 (in ") == 0);
+
+    // The bucket is refilled with 10 messages per second
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    log(100);
+    res = lines(out);
+    assert(res.size() == 1);
+    assert(res[0].find("rate 100 [") == 0);
+    assert(res[0].find(" similar messages suppressed] (in ") != std::string::npos);
+}
+
+void testDisabled(std::ostringstream& out) {
+    int evaluated = 0;
+    logger->config.level = LogLevel::ERROR;
+    for (int i = 0; i < 10; ++i) {
+        LOG_WARN_EVERY_N(1, "disabled %1%", ++evaluated);
+    }
+    logger->config.level = LogLevel::TRACE;
+    assert(evaluated == 0);
+    assert(lines(out).empty());
+}
+
+} // anonymous namespace
+
+int main() {
+    std::ostringstream out;
+    logger->config.warnOut = &out;
+    logger->config.level = LogLevel::TRACE;
+
+    testEveryN(out);
+    testEveryMs(out);
+    testRate(out);
+    testDisabled(out);
+
+    logger->config.warnOut = &std::clog;
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/program_options.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace crossbow::program_options;
+
+namespace {
+
+auto createOptions() -> decltype(create_options("", value<'c'>("poll-cycles", (uint64_t*) nullptr),
+        value<'b'>("buffer-count", (unsigned*) nullptr), value<'f'>("factor", (double*) nullptr),
+        value<'v'>("verbose", (bool*) nullptr), value<'n'>("name", (crossbow::string*) nullptr))) {
+    return create_options("po_config_test",
+            value<'c'>("poll-cycles", (uint64_t*) nullptr),
+            value<'b'>("buffer-count", (unsigned*) nullptr),
+            value<'f'>("factor", (double*) nullptr),
+            value<'v'>("verbose", (bool*) nullptr),
+            value<'n'>("name", (crossbow::string*) nullptr));
+}
+
+template<class Fun>
+bool throwsParseError(Fun fun) {
+    try {
+        fun();
+    } catch (parse_error &) {
+        return true;
+    }
+    return false;
+}
+
+void testParsers() {
+    assert(parser<int>()("-42") == -42);
+    assert(parser<int>()("0x10") == 16);
+    assert(parser<int>()("12 ") == 12);
+    assert(parser<short>()("-32768") == -32768);
+    assert(parser<unsigned long long>()("18446744073709551615") == 18446744073709551615ull);
+    assert(parser<double>()("2.5") == 2.5);
+    assert(parser<bool>()("On") && !parser<bool>()("0"));
+
+    assert(throwsParseError([] { parser<int>()(""); }));
+    assert(throwsParseError([] { parser<int>()("12abc"); }));
+    assert(throwsParseError([] { parser<int>()("4294967296"); }));
+    assert(throwsParseError([] { parser<short>()("32768"); }));
+    assert(throwsParseError([] { parser<unsigned>()("4294967296"); }));
+    assert(throwsParseError([] { parser<long>()("99999999999999999999"); }));
+    assert(throwsParseError([] { parser<float>()("1e100"); }));
+    assert(throwsParseError([] { parser<double>()("x"); }));
+    assert(throwsParseError([] { parser<bool>()("maybe"); }));
+}
+
+void testStream() {
+    auto opts = createOptions();
+    std::istringstream in(
+            "# Infiniband tunables\n"
+            "\n"
+            "poll-cycles = 1000000\n"
+            "  buffer-count=256  \n"
+            "factor = 0.5\n"
+            "verbose = yes\n"
+            "name = node 1\n");
+    parse_stream(opts, in);
+    assert(get<'c'>(opts) == 1000000);
+    assert(get<'b'>(opts) == 256);
+    assert(get<'f'>(opts) == 0.5);
+    assert(get<'v'>(opts));
+    assert(get<'n'>(opts) == "node 1");
+
+    std::istringstream unknown("unknown = 1\n");
+    assert(throwsParseError([&] { parse_stream(opts, unknown); }));
+    std::istringstream missing("poll-cycles 1\n");
+    assert(throwsParseError([&] { parse_stream(opts, missing); }));
+    assert(throwsParseError([&] { parse_file(opts, "/nonexistent/crossbow.conf"); }));
+}
+
+void testEnv() {
+    auto opts = createOptions();
+    setenv("PO_TEST_POLL_CYCLES", "77", 1);
+    setenv("PO_TEST_VERBOSE", "true", 1);
+    parse_env(opts, "PO_TEST_");
+    assert(get<'c'>(opts) == 77);
+    assert(get<'v'>(opts));
+    assert(get<'b'>(opts) == 0);
+}
+
+void testLive() {
+    auto live = make_live(createOptions());
+    using live_type = decltype(live)::element_type;
+    uint64_t hookValue = 0;
+    live->on_reload([&hookValue](const live_type::snapshot_type &snapshot) {
+        hookValue = get<'c'>(snapshot);
+    });
+
+    auto before = live->snapshot();
+    assert(get<'c'>(before) == 0);
+
+    std::thread reader([&live] {
+        live_type::view view(*live);
+        uint64_t last = 0;
+        while (last != 100) {
+            auto &opts = view.get();
+            auto current = opts.get<'c'>();
+            assert(current >= last && current <= 100);
+            assert(opts.get<'b'>() == current * 2);
+            last = current;
+        }
+    });
+    for (uint64_t i = 1; i <= 100; ++i) {
+        live->reload([i](std::unique_ptr<live_type::options_type> &next) {
+            set(next, "poll-cycles", std::to_string(i).c_str());
+            set(next, "buffer-count", std::to_string(i * 2).c_str());
+        });
+    }
+    reader.join();
+    assert(live->version() == 100);
+    assert(hookValue == 100);
+
+    // Old snapshots stay valid and unchanged
+    assert(get<'c'>(before) == 0);
+
+    // A failing reload keeps the current snapshot
+    assert(throwsParseError([&live] {
+        live->reload([](std::unique_ptr<live_type::options_type> &next) {
+            set(next, "poll-cycles", "1");
+            set(next, "buffer-count", "-");
+        });
+    }));
+    assert(live->version() == 100);
+    assert(get<'c'>(live->snapshot()) == 100);
+}
+
+} // anonymous namespace
+
+int main() {
+    testParsers();
+    testStream();
+    testEnv();
+    testLive();
+}
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/protocol/FiberClient.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <tuple>
+
+GEN_COMMANDS(Cmd, (ADD, PING));
+
+template<Cmd C>
+struct Signature;
+
+template<>
+struct Signature<Cmd::ADD> {
+    using arguments = std::tuple<int32_t, int32_t>;
+    using result = int32_t;
+};
+
+template<>
+struct Signature<Cmd::PING> {
+    using arguments = void;
+    using result = void;
+};
+
+namespace {
+
+struct Implementation {
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::ADD>::type execute(const std::tuple<int32_t, int32_t>& args,
+            const Callback& callback) {
+        callback(std::get<0>(args) + std::get<1>(args));
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::PING>::type execute(const Callback& callback) {
+        callback();
+    }
+
+    void close() {
+    }
+};
+
+using Server = crossbow::protocol::Server<Cmd_Switch, Cmd, Signature, Implementation>;
+using Client = crossbow::protocol::Client<Cmd, Signature>;
+using FiberClient = crossbow::protocol::FiberClient<Cmd, Signature>;
+
+} // anonymous namespace
+
+int main() {
+    using boost::asio::ip::tcp;
+    constexpr int32_t numFibers = 1000;
+    constexpr int32_t numCalls = 10;
+
+    boost::asio::io_service service;
+    tcp::acceptor acceptor(service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket clientSocket(service);
+    clientSocket.connect(acceptor.local_endpoint());
+    tcp::socket serverSocket(service);
+    acceptor.accept(serverSocket);
+
+    Implementation impl;
+    Server server(impl, serverSocket);
+    server.run();
+
+    Client client(clientSocket);
+    FiberClient fiberClient(client);
+
+    // Every fiber issues a chain of dependent requests, all fibers share the connection
+    int32_t finished = 0;
+    for (int32_t i = 0; i < numFibers; ++i) {
+        boost::asio::spawn(service, [&fiberClient, &finished, i](boost::asio::yield_context yield) {
+            int32_t value = i;
+            for (int32_t j = 0; j < numCalls; ++j) {
+                value = fiberClient.execute<Cmd::ADD>(yield, value, int32_t(1));
+                fiberClient.execute<Cmd::PING>(yield);
+            }
+            assert(value == i + numCalls);
+            ++finished;
+        });
+    }
+    while (finished != numFibers) {
+        service.run_one();
+    }
+
+    // Errors are reported through the error code or as exception
+    serverSocket.close();
+    bool failedCode = false;
+    bool failedException = false;
+    boost::asio::spawn(service, [&fiberClient, &failedCode, &failedException](boost::asio::yield_context yield) {
+        boost::system::error_code ec;
+        fiberClient.execute<Cmd::ADD>(yield[ec], int32_t(1), int32_t(2));
+        failedCode = static_cast<bool>(ec);
+        try {
+            fiberClient.execute<Cmd::PING>(yield);
+        } catch (boost::system::system_error&) {
+            failedException = true;
+        }
+    });
+    while (!failedException) {
+        service.run_one();
+    }
+    assert(failedCode);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/protocol/FramedReader.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace crossbow::protocol;
+
+namespace {
+
+std::vector<uint8_t> makeFrame(size_t size, uint8_t fill) {
+    std::vector<uint8_t> frame(size, fill);
+    memcpy(frame.data(), &size, sizeof(size));
+    return frame;
+}
+
+} // anonymous namespace
+
+int main() {
+    {
+        BufferPool pool(1);
+        auto a = pool.acquire(100);
+        assert(a.capacity == 1024);
+        auto data = a.data.get();
+        pool.release(std::move(a));
+        auto b = pool.acquire(1000);
+        assert(b.data.get() == data);
+        auto c = pool.acquire(5000);
+        assert(c.capacity == 8192);
+        pool.release(std::move(b));
+        pool.release(std::move(c));
+
+        bool thrown = false;
+        try {
+            pool.acquire(BufferPool::MAX_SIZE + 1);
+        } catch (std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    using boost::asio::ip::tcp;
+    boost::asio::io_service service;
+    tcp::acceptor acceptor(service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket writer(service);
+    writer.connect(acceptor.local_endpoint());
+    tcp::socket socket(service);
+    acceptor.accept(socket);
+
+    // Frames fitting into the buffer, spanning the buffer end and larger than the buffer
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < 200; ++i) {
+        frames.emplace_back(makeFrame(sizeof(size_t) + (i * 7) % 300, static_cast<uint8_t>(i)));
+        stream.insert(stream.end(), frames.back().begin(), frames.back().end());
+    }
+
+    BufferPool pool;
+    size_t received = 0;
+    bool failed = false;
+    size_t stopAt = 50;
+    FramedReader reader(socket, pool, sizeof(size_t),
+            [&](const boost::system::error_code& ec, const uint8_t* frame, size_t size) {
+                if (ec) {
+                    failed = true;
+                    return false;
+                }
+                assert(received < frames.size());
+                assert(size == frames[received].size());
+                assert(memcmp(frame, frames[received].data(), size) == 0);
+                ++received;
+                return received != stopAt;
+            }, 128);
+
+    // Write the stream in odd sized chunks
+    for (size_t offset = 0; offset < stream.size(); offset += 333) {
+        auto length = std::min(stream.size() - offset, size_t(333));
+        boost::asio::write(writer, boost::asio::buffer(stream.data() + offset, length));
+    }
+
+    service.reset();
+    reader.start();
+    while (reader.active()) {
+        service.run_one();
+    }
+    assert(received == stopAt);
+
+    // Continues with the buffered data
+    stopAt = frames.size();
+    service.reset();
+    reader.start();
+    while (reader.active()) {
+        service.run_one();
+    }
+    assert(received == frames.size());
+    assert(!failed);
+
+    // Closing the connection reports an error
+    writer.close();
+    service.reset();
+    reader.start();
+    while (reader.active()) {
+        service.run_one();
+    }
+    assert(failed);
+
+    // Frame sizes above the maximum are rejected without allocating
+    for (auto frameSize : {size_t(4096), std::numeric_limits<size_t>::max()}) {
+        tcp::socket peer(service);
+        peer.connect(acceptor.local_endpoint());
+        tcp::socket conn(service);
+        acceptor.accept(conn);
+
+        boost::system::error_code error;
+        FramedReader limited(conn, pool, sizeof(size_t),
+                [&](const boost::system::error_code& ec, const uint8_t*, size_t) {
+                    error = ec;
+                    return false;
+                }, 128, 1024);
+        auto frame = makeFrame(sizeof(size_t) * 2, 0);
+        memcpy(frame.data(), &frameSize, sizeof(frameSize));
+        boost::asio::write(peer, boost::asio::buffer(frame));
+
+        service.reset();
+        limited.start();
+        while (limited.active()) {
+            service.run_one();
+        }
+        assert(error == boost::system::errc::make_error_code(boost::system::errc::bad_message));
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Protocol.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+GEN_COMMANDS(Cmd, (ADD, PING, REPEAT));
+
+template<Cmd C>
+struct Signature;
+
+template<>
+struct Signature<Cmd::ADD> {
+    using arguments = std::tuple<int32_t, int32_t>;
+    using result = int32_t;
+};
+
+template<>
+struct Signature<Cmd::PING> {
+    using arguments = void;
+    using result = void;
+};
+
+template<>
+struct Signature<Cmd::REPEAT> {
+    using arguments = std::string;
+    using result = std::string;
+};
+
+namespace {
+
+struct Implementation {
+    size_t pings = 0;
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::ADD>::type execute(const std::tuple<int32_t, int32_t>& args,
+            const Callback& callback) {
+        callback(std::get<0>(args) + std::get<1>(args));
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::PING>::type execute(const Callback& callback) {
+        ++pings;
+        callback();
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::REPEAT>::type execute(const std::string& args, const Callback& callback) {
+        callback(args);
+    }
+
+    void close() {
+    }
+};
+
+using Server = crossbow::protocol::Server<Cmd_Switch, Cmd, Signature, Implementation>;
+using Client = crossbow::protocol::Client<Cmd, Signature>;
+
+} // anonymous namespace
+
+int main() {
+    using boost::asio::ip::tcp;
+    using error_code = boost::system::error_code;
+    constexpr int32_t numRequests = 1000;
+
+    boost::asio::io_service service;
+    tcp::acceptor acceptor(service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket clientSocket(service);
+    clientSocket.connect(acceptor.local_endpoint());
+    tcp::socket serverSocket(service);
+    acceptor.accept(serverSocket);
+
+    Implementation impl;
+    Server server(impl, serverSocket);
+    server.run();
+
+    Client client(clientSocket);
+    std::vector<int32_t> sums(numRequests, -1);
+    size_t pongs = 0;
+    size_t repeats = 0;
+    std::string largeString(100000, 'x');
+
+    // Issue all requests without waiting for any response
+    for (int32_t i = 0; i < numRequests; ++i) {
+        client.execute<Cmd::ADD>([&sums, i](const error_code& ec, int32_t result) {
+            assert(!ec);
+            sums[i] = result;
+        }, i, 2 * i);
+        client.execute<Cmd::PING>([&pongs](const error_code& ec) {
+            assert(!ec);
+            ++pongs;
+        });
+    }
+    client.execute<Cmd::REPEAT>([&repeats, &largeString](const error_code& ec, const std::string& result) {
+        assert(!ec);
+        assert(result == largeString);
+        ++repeats;
+    }, largeString);
+    assert(client.pending() == 2 * numRequests + 1);
+
+    while (client.pending() != 0) {
+        service.run_one();
+    }
+    for (int32_t i = 0; i < numRequests; ++i) {
+        assert(sums[i] == 3 * i);
+    }
+    assert(pongs == numRequests);
+    assert(impl.pings == numRequests);
+    assert(repeats == 1);
+
+    // Pending requests fail when the connection is closed
+    bool failed = false;
+    client.execute<Cmd::REPEAT>([&failed](const error_code& ec, const std::string&) {
+        failed = static_cast<bool>(ec);
+    }, std::string("foo"));
+    serverSocket.close();
+    while (client.pending() != 0) {
+        service.run_one();
+    }
+    assert(failed);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Protocol.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+GEN_COMMANDS(Cmd, (PING, QUIT));
+
+template<Cmd C>
+struct Signature;
+
+template<>
+struct Signature<Cmd::PING> {
+    using arguments = void;
+    using result = void;
+};
+
+template<>
+struct Signature<Cmd::QUIT> {
+    using arguments = void;
+    using result = std::string;
+};
+
+namespace {
+
+struct Implementation;
+
+using Server = crossbow::protocol::Server<Cmd_Switch, Cmd, Signature, Implementation>;
+using Client = crossbow::protocol::Client<Cmd, Signature>;
+
+struct Implementation {
+    Server* server = nullptr;
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::PING>::type execute(const Callback& callback) {
+        callback();
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::QUIT>::type execute(const Callback& callback) {
+        server->quit();
+        callback(std::string(100000, 'q'));
+    }
+
+    void close() {
+    }
+};
+
+/**
+ * @brief The reply to the quit request is sent before the io_service of the server stops
+ */
+void testQuit() {
+    using boost::asio::ip::tcp;
+    using error_code = boost::system::error_code;
+
+    boost::asio::io_service clientService;
+    boost::asio::io_service serverService;
+    tcp::acceptor acceptor(serverService, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket clientSocket(clientService);
+    clientSocket.connect(acceptor.local_endpoint());
+    tcp::socket serverSocket(serverService);
+    acceptor.accept(serverSocket);
+
+    Implementation impl;
+    Server server(impl, serverSocket);
+    impl.server = &server;
+    server.run();
+    std::thread serverThread([&serverService] () {
+        serverService.run();
+    });
+
+    Client client(clientSocket);
+    size_t pongs = 0;
+    std::string reply;
+    client.execute<Cmd::PING>([&pongs](const error_code& ec) {
+        assert(!ec);
+        ++pongs;
+    });
+    client.execute<Cmd::QUIT>([&reply](const error_code& ec, const std::string& result) {
+        assert(!ec);
+        reply = result;
+    });
+    while (client.pending() != 0) {
+        clientService.run_one();
+    }
+    serverThread.join();
+    assert(pongs == 1);
+    assert(reply == std::string(100000, 'q'));
+    assert(serverService.stopped());
+}
+
+/**
+ * @brief Handlers of a destroyed queue still pending on the io_service are ignored
+ */
+void testDestroyedQueue() {
+    using boost::asio::ip::tcp;
+
+    boost::asio::io_service service;
+    tcp::acceptor acceptor(service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket clientSocket(service);
+    clientSocket.connect(acceptor.local_endpoint());
+    tcp::socket serverSocket(service);
+    acceptor.accept(serverSocket);
+
+    crossbow::protocol::BufferPool pool;
+    {
+        crossbow::protocol::WriteQueue queue(service, clientSocket, pool,
+                [](const boost::system::error_code&) { assert(false); });
+        queue.write(pool.acquire(64), 64);
+    }
+    service.poll();
+}
+
+} // anonymous namespace
+
+int main() {
+    testQuit();
+    testDestroyedQueue();
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/protocol/ShardedServer.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+GEN_COMMANDS(Cmd, (ADD, PING));
+
+template<Cmd C>
+struct Signature;
+
+template<>
+struct Signature<Cmd::ADD> {
+    using arguments = std::tuple<int32_t, int32_t>;
+    using result = int32_t;
+};
+
+template<>
+struct Signature<Cmd::PING> {
+    using arguments = void;
+    using result = void;
+};
+
+namespace {
+
+std::atomic<size_t> gClosed(0);
+
+struct Implementation {
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::ADD>::type execute(const std::tuple<int32_t, int32_t>& args,
+            const Callback& callback) {
+        callback(std::get<0>(args) + std::get<1>(args));
+    }
+
+    template<Cmd C, class Callback>
+    typename std::enable_if<C == Cmd::PING>::type execute(const Callback& callback) {
+        callback();
+    }
+
+    void close() {
+        ++gClosed;
+    }
+};
+
+using ShardedServer = crossbow::protocol::ShardedServer<Cmd_Switch, Cmd, Signature, Implementation>;
+using Client = crossbow::protocol::Client<Cmd, Signature>;
+
+template<class Predicate>
+void waitFor(Predicate predicate) {
+    while (!predicate()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void runClients(ShardedServer& server, size_t numClients) {
+    using boost::asio::ip::tcp;
+    using error_code = boost::system::error_code;
+    constexpr int32_t numRequests = 100;
+
+    boost::asio::io_service service;
+    std::vector<std::unique_ptr<tcp::socket>> sockets;
+    std::vector<std::unique_ptr<Client>> clients;
+    size_t completed = 0;
+    for (size_t i = 0; i < numClients; ++i) {
+        sockets.emplace_back(new tcp::socket(service));
+        sockets.back()->connect(server.localEndpoint());
+        clients.emplace_back(new Client(*sockets.back()));
+        for (int32_t j = 0; j < numRequests; ++j) {
+            clients.back()->execute<Cmd::ADD>([&completed, j](const error_code& ec, int32_t result) {
+                assert(!ec);
+                assert(result == 2 * j + 1);
+                ++completed;
+            }, j, j + 1);
+            clients.back()->execute<Cmd::PING>([&completed](const error_code& ec) {
+                assert(!ec);
+                ++completed;
+            });
+        }
+    }
+    while (completed != numClients * numRequests * 2) {
+        service.run_one();
+    }
+    assert(server.connections() == numClients);
+
+    // Closed connections are removed from the server
+    auto closed = gClosed.load();
+    for (auto& socket : sockets) {
+        socket->close();
+    }
+    waitFor([&server] () { return server.connections() == 0; });
+    assert(gClosed.load() == closed + numClients);
+}
+
+} // anonymous namespace
+
+int main() {
+    auto loopback = boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0);
+    auto factory = [] (size_t) {
+        return std::unique_ptr<Implementation>(new Implementation());
+    };
+    {
+        ShardedServer server(loopback, 3, factory);
+        server.start();
+        runClients(server, 8);
+        server.stop();
+    }
+    {
+        ShardedServer server(loopback, 2, factory, true);
+        server.start();
+        runClients(server, 4);
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Serializer.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Entry {
+    uint64_t key;
+    std::string value;
+    std::vector<uint32_t> tags;
+
+    template<class Archiver>
+    void visit(Archiver& ar) {
+        ar & key;
+        ar & value;
+        ar & tags;
+    }
+};
+
+// Segments handing out fixed size buffers from a pool and recording the appended data
+class TestSegments {
+public:
+    TestSegments(size_t segmentSize, size_t maxSegments)
+            : mSegmentSize(segmentSize),
+              mMaxSegments(maxSegments) {
+    }
+
+    crossbow::buffer_writer acquire() {
+        if (mSegments.size() == mMaxSegments) {
+            return crossbow::buffer_writer(static_cast<char*>(nullptr), 0);
+        }
+        mSegments.emplace_back(new char[mSegmentSize]);
+        return crossbow::buffer_writer(mSegments.back().get(), mSegmentSize);
+    }
+
+    void append(const char* data, size_t length) {
+        assert(length <= mSegmentSize);
+        ++appended;
+        result.insert(result.end(), data, data + length);
+    }
+
+    std::vector<uint8_t> result;
+    size_t appended = 0;
+
+private:
+    size_t mSegmentSize;
+    size_t mMaxSegments;
+    std::vector<std::unique_ptr<char[]>> mSegments;
+};
+
+template<class T>
+std::vector<uint8_t> toBytes(const T& obj) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto size = crossbow::serialize(buffer, obj);
+    return std::vector<uint8_t>(buffer.get(), buffer.get() + size);
+}
+
+} // anonymous namespace
+
+int main() {
+    std::vector<Entry> entries;
+    for (uint64_t i = 0; i < 100; ++i) {
+        entries.push_back(Entry{i, std::string(i * 3, 'a' + (i % 26)), std::vector<uint32_t>(i % 7, i)});
+    }
+    auto expected = toBytes(entries);
+
+    {
+        // Fits into a single buffer
+        std::vector<char> data(expected.size());
+        crossbow::buffer_writer writer(data.data(), data.size());
+        crossbow::serialize(writer, entries);
+        assert(writer.exhausted());
+        assert(std::vector<uint8_t>(data.begin(), data.end()) == expected);
+    }
+    {
+        // Does not fit into a single buffer
+        std::vector<char> data(expected.size() - 1);
+        crossbow::buffer_writer writer(data.data(), data.size());
+        bool failed = false;
+        try {
+            crossbow::serialize(writer, entries);
+        } catch (std::length_error&) {
+            failed = true;
+        }
+        assert(failed);
+        // The writer is left untouched
+        assert(writer.data() == data.data());
+    }
+    {
+        // Spans multiple segments, strings longer than a segment are split
+        TestSegments segments(64, 1000);
+        std::vector<char> first(40);
+        crossbow::buffer_writer writer(first.data(), first.size());
+        crossbow::serialize(writer, entries, segments);
+        assert(segments.appended > 2);
+        assert(segments.result == expected);
+        // The writer is only advanced past the data written into the initial buffer
+        assert(writer.data() > first.data() && writer.data() <= first.data() + first.size());
+
+        std::vector<Entry> out;
+        crossbow::deserialize(out, segments.result.data());
+        assert(out.size() == entries.size());
+        assert(out[99].value == entries[99].value);
+        assert(out[99].tags == entries[99].tags);
+    }
+    {
+        // Maps are split at element boundaries
+        std::map<uint32_t, std::string> map;
+        for (uint32_t i = 0; i < 50; ++i) {
+            map.emplace(i, std::to_string(i));
+        }
+        TestSegments segments(16, 1000);
+        std::vector<char> first(16);
+        crossbow::buffer_writer writer(first.data(), first.size());
+        crossbow::serialize(writer, map, segments);
+        assert(segments.result == toBytes(map));
+    }
+    {
+        // Runs out of segments
+        TestSegments segments(64, 2);
+        std::vector<char> first(64);
+        crossbow::buffer_writer writer(first.data(), first.size());
+        bool failed = false;
+        try {
+            crossbow::serialize(writer, entries, segments);
+        } catch (std::length_error&) {
+            failed = true;
+        }
+        assert(failed);
+        assert(writer.data() == first.data());
+    }
+    {
+        // PODs longer than a segment are split
+        std::vector<std::array<uint32_t, 50>> arrays(3);
+        for (uint32_t i = 0; i < 50; ++i) {
+            arrays[0][i] = i;
+            arrays[1][i] = 2 * i;
+            arrays[2][i] = 3 * i;
+        }
+        TestSegments segments(64, 1000);
+        std::vector<char> first(16);
+        crossbow::buffer_writer writer(first.data(), first.size());
+        crossbow::serialize(writer, arrays, segments);
+        assert(segments.result == toBytes(arrays));
+    }
+    return 0;
+}
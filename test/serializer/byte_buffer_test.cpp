@@ -0,0 +1,133 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/byte_buffer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class Kind : uint16_t {
+    PING = 0x0102
+};
+
+void testUnaligned() {
+    std::vector<char> data(64, 0);
+    for (size_t offset = 0; offset < 8; ++offset) {
+        crossbow::buffer_writer writer(data.data() + offset, data.size() - offset);
+        writer.write<uint8_t>(1);
+        writer.write<uint64_t>(0x0102030405060708ull);
+        writer.write<double>(2.5);
+        writer.write<Kind>(Kind::PING);
+
+        crossbow::buffer_reader reader(data.data() + offset, data.size() - offset);
+        assert(reader.read<uint8_t>() == 1);
+        assert(reader.read<uint64_t>() == 0x0102030405060708ull);
+        assert(reader.read<double>() == 2.5);
+        assert(reader.read<Kind>() == Kind::PING);
+        assert(reader.remaining() == data.size() - offset - 19);
+    }
+}
+
+void testChecked() {
+    std::vector<char> data(10, 0);
+    crossbow::buffer_writer writer(data.data(), data.size());
+    assert(writer.tryWrite<uint64_t>(42));
+    assert(!writer.tryWrite<uint32_t>(1));
+    assert(writer.remaining() == 2);
+    assert(writer.tryWrite<uint16_t>(7));
+    assert(writer.exhausted());
+
+    crossbow::buffer_reader reader(data.data(), data.size());
+    uint64_t a = 0;
+    uint32_t b = 0;
+    uint16_t c = 0;
+    assert(reader.tryRead(a) && a == 42);
+    assert(!reader.tryRead(b));
+    assert(reader.remaining() == 2);
+    assert(reader.tryRead(c) && c == 7);
+    assert(!reader.tryRead(c));
+    assert(reader.exhausted());
+
+    // Lengths that would overflow the pointer arithmetic are rejected
+    assert(!reader.canRead(SIZE_MAX));
+    assert(!writer.canWrite(SIZE_MAX - 1));
+}
+
+void testArrays() {
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 100; ++i) {
+        values.push_back(i * 7);
+    }
+    std::vector<char> data(1 + values.size() * sizeof(uint32_t), 0);
+    crossbow::buffer_writer writer(data.data(), data.size());
+    writer.write<uint8_t>(3);
+    assert(!writer.tryWriteArray(values.data(), values.size() + 1));
+    writer.writeArray(values.data(), values.size());
+    assert(writer.exhausted());
+
+    crossbow::buffer_reader reader(data.data(), data.size());
+    assert(reader.read<uint8_t>() == 3);
+    std::vector<uint32_t> res(values.size() + 1);
+    assert(!reader.tryReadArray(res.data(), res.size()));
+    assert(reader.tryReadArray(res.data(), values.size()));
+    res.pop_back();
+    assert(res == values);
+    assert(reader.exhausted());
+}
+
+void testEndian() {
+    unsigned char data[32] = {};
+    crossbow::buffer_writer writer(data, sizeof(data));
+    writer.writeLittleEndian<uint32_t>(0x01020304u);
+    writer.writeBigEndian<uint32_t>(0x01020304u);
+    writer.writeBigEndian<uint16_t>(0xA0B0u);
+    writer.writeBigEndian<int64_t>(-2);
+    writer.writeBigEndian<float>(1.0f);
+
+    const unsigned char expected[] = {
+        0x04, 0x03, 0x02, 0x01,
+        0x01, 0x02, 0x03, 0x04,
+        0xA0, 0xB0,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0x3F, 0x80, 0x00, 0x00
+    };
+    assert(memcmp(data, expected, sizeof(expected)) == 0);
+
+    crossbow::buffer_reader reader(reinterpret_cast<const char*>(data), sizeof(data));
+    assert(reader.readLittleEndian<uint32_t>() == 0x01020304u);
+    assert(reader.readBigEndian<uint32_t>() == 0x01020304u);
+    assert(reader.readBigEndian<uint16_t>() == 0xA0B0u);
+    assert(reader.readBigEndian<int64_t>() == -2);
+    assert(reader.readBigEndian<float>() == 1.0f);
+}
+
+} // anonymous namespace
+
+int main() {
+    testUnaligned();
+    testChecked();
+    testArrays();
+    testEndian();
+}
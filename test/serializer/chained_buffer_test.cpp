@@ -0,0 +1,169 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/chained_buffer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string expectedPayload(size_t length) {
+    std::string result;
+    for (size_t i = 0; i < length; ++i) {
+        result.push_back(static_cast<char>('a' + i % 26));
+    }
+    return result;
+}
+
+void testBackpatch() {
+    crossbow::chained_buffer_pool pool(16);
+    crossbow::chained_buffer buffer(pool);
+    assert(buffer.empty() && buffer.segmentCount() == 0);
+
+    auto length = buffer.reserve<uint32_t>();
+    buffer.write<uint8_t>(7);
+    auto payload = expectedPayload(40);
+    buffer.write(payload.data(), payload.size());
+    buffer.write<uint64_t>(0x0102030405060708ull);
+    length.setBigEndian(static_cast<uint32_t>(buffer.size() - sizeof(uint32_t)));
+
+    assert(buffer.size() == 4 + 1 + 40 + 8);
+    assert(buffer.segmentCount() > 1);
+
+    auto flat = buffer.flatten();
+    assert(flat.size() == buffer.size());
+    crossbow::buffer_reader reader(flat.data(), flat.size());
+    assert(reader.readBigEndian<uint32_t>() == 49);
+    assert(reader.read<uint8_t>() == 7);
+    assert(std::string(reader.read(40), 40) == payload);
+    assert(reader.read<uint64_t>() == 0x0102030405060708ull);
+    assert(reader.exhausted());
+}
+
+void testSegments() {
+    crossbow::chained_buffer_pool pool(8);
+    crossbow::chained_buffer buffer(pool);
+    buffer.write<uint32_t>(1);
+    buffer.write<uint32_t>(2);
+    // Does not fit into the first segment and is moved to the second one
+    buffer.write<uint64_t>(3);
+    buffer.write<uint16_t>(4);
+    buffer.write<uint64_t>(5);
+    assert(buffer.size() == 26);
+    assert(buffer.segmentCount() == 4);
+    assert(buffer.at(0).length == 8);
+    assert(buffer.at(1).length == 8);
+    assert(buffer.at(2).length == 2);
+    assert(buffer.at(3).length == 8);
+
+    std::vector<struct iovec> iov;
+    buffer.appendTo(iov);
+    assert(iov.size() == 4);
+    size_t total = 0;
+    for (auto& v : iov) {
+        total += v.iov_len;
+    }
+    assert(total == buffer.size());
+
+    std::vector<char> data(buffer.size() + 4);
+    crossbow::buffer_writer writer(data.data(), data.size());
+    buffer.copyTo(writer);
+    assert(writer.remaining() == 4);
+    crossbow::buffer_reader reader(data.data(), buffer.size());
+    assert(reader.read<uint32_t>() == 1);
+    assert(reader.read<uint32_t>() == 2);
+    assert(reader.read<uint64_t>() == 3);
+    assert(reader.read<uint16_t>() == 4);
+    assert(reader.read<uint64_t>() == 5);
+
+    auto small = crossbow::buffer_writer(data.data(), 3);
+    bool thrown = false;
+    try {
+        buffer.copyTo(small);
+    } catch (std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        buffer.extract(9);
+    } catch (std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testPoolReuse() {
+    std::vector<char> memory(64);
+    crossbow::chained_buffer_pool pool(memory.data(), memory.size(), 16);
+    {
+        crossbow::chained_buffer buffer(pool);
+        auto payload = expectedPayload(64);
+        buffer.write(payload.data(), payload.size());
+        assert(buffer.segmentCount() == 4);
+        for (size_t i = 0; i < buffer.segmentCount(); ++i) {
+            auto s = buffer.at(i);
+            assert(s.data >= memory.data() && s.data + s.length <= memory.data() + memory.size());
+        }
+
+        // All segments of the memory area are in use
+        bool thrown = false;
+        try {
+            buffer.write<uint8_t>(1);
+        } catch (std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        buffer.reset();
+        assert(buffer.empty() && buffer.segmentCount() == 1);
+        buffer.write(payload.data(), 20);
+
+        crossbow::chained_buffer moved(std::move(buffer));
+        assert(buffer.empty() && moved.size() == 20);
+        auto flat = moved.flatten();
+        assert(std::string(flat.data(), flat.size()) == payload.substr(0, 20));
+    }
+
+    // Destroying the buffer returned its segments
+    crossbow::chained_buffer buffer(pool);
+    auto writer = buffer.extract(16);
+    writer.set(0, 16);
+    for (int i = 0; i < 3; ++i) {
+        buffer.write<uint64_t>(i);
+        buffer.write<uint64_t>(i);
+    }
+    assert(buffer.size() == 64);
+}
+
+} // anonymous namespace
+
+int main() {
+    testBackpatch();
+    testSegments();
+    testPoolReuse();
+}
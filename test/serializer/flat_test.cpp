@@ -0,0 +1,173 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Serializer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class Kind : uint16_t {
+    PING = 1,
+    PONG
+};
+
+// Packed struct: serialized with a single memcpy
+struct Header {
+    uint64_t id;
+    uint32_t type;
+    uint32_t length;
+
+    using serializable_members = crossbow::member_list<
+            CROSSBOW_MEMBER(Header, id),
+            CROSSBOW_MEMBER(Header, type),
+            CROSSBOW_MEMBER(Header, length)>;
+
+    template<class Archiver>
+    void visit(Archiver& ar) {
+        ar & id;
+        ar & type;
+        ar & length;
+    }
+};
+
+// Struct with padding and a nested flat struct: serialized member by member
+struct Request {
+    Kind kind;
+    Header header;
+    uint8_t flags;
+    double value;
+
+    using serializable_members = crossbow::member_list<
+            CROSSBOW_MEMBER(Request, kind),
+            CROSSBOW_MEMBER(Request, header),
+            CROSSBOW_MEMBER(Request, flags),
+            CROSSBOW_MEMBER(Request, value)>;
+};
+
+// Same layout as Request but serialized through visit
+struct VisitedRequest {
+    Kind kind;
+    Header header;
+    uint8_t flags;
+    double value;
+
+    template<class Archiver>
+    void visit(Archiver& ar) {
+        ar & kind;
+        ar & header.id;
+        ar & header.type;
+        ar & header.length;
+        ar & flags;
+        ar & value;
+    }
+};
+
+// Contains a bool which is not flat
+struct NotFlat {
+    uint32_t a;
+    bool b;
+
+    using serializable_members = crossbow::member_list<
+            CROSSBOW_MEMBER(NotFlat, a),
+            CROSSBOW_MEMBER(NotFlat, b)>;
+
+    template<class Archiver>
+    void visit(Archiver& ar) {
+        ar & a;
+        ar & b;
+    }
+};
+
+static_assert(crossbow::is_flat_serializable<Header>::value, "Header must be flat");
+static_assert(crossbow::is_flat_serializable<Request>::value, "Request must be flat");
+static_assert(!crossbow::is_flat_serializable<NotFlat>::value, "NotFlat must not be flat");
+static_assert(!crossbow::is_flat_serializable<VisitedRequest>::value, "VisitedRequest must not be flat");
+static_assert(!crossbow::is_flat_serializable<uint64_t>::value, "Primitives use the default policies");
+static_assert(crossbow::flat_size<Header>() == 16, "Wrong size");
+static_assert(crossbow::flat_size<Request>() == 2 + 16 + 1 + 8, "Wrong size");
+
+template<class T>
+std::vector<uint8_t> toBytes(const T& obj) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto size = crossbow::serialize(buffer, obj);
+    return std::vector<uint8_t>(buffer.get(), buffer.get() + size);
+}
+
+} // anonymous namespace
+
+int main() {
+    {
+        Header header{0x0102030405060708ull, 7u, 42u};
+        assert(crossbow::flat_layout<Header>::packed(header));
+
+        crossbow::sizer sizer;
+        sizer & header;
+        assert(sizer.size == 16);
+
+        // The flat path must produce the same bytes as visit
+        auto bytes = toBytes(header);
+        std::vector<uint8_t> visited(16);
+        crossbow::serializer_into_array ser(visited.data());
+        header.visit(ser);
+        assert(bytes == visited);
+
+        Header out{0, 0, 0};
+        auto end = crossbow::deserialize(out, bytes.data());
+        assert(end == bytes.data() + bytes.size());
+        assert(out.id == header.id && out.type == header.type && out.length == header.length);
+    }
+    {
+        Request request{Kind::PONG, Header{1u, 2u, 3u}, 0x7fu, 3.5};
+        assert(!crossbow::flat_layout<Request>::packed(request));
+
+        VisitedRequest visitedRequest{Kind::PONG, Header{1u, 2u, 3u}, 0x7fu, 3.5};
+        auto bytes = toBytes(request);
+        assert(bytes.size() == crossbow::flat_size<Request>());
+        assert(bytes == toBytes(visitedRequest));
+
+        Request out{Kind::PING, Header{0u, 0u, 0u}, 0u, 0.0};
+        crossbow::deserialize(out, bytes.data());
+        assert(out.kind == Kind::PONG);
+        assert(out.header.id == 1u && out.header.type == 2u && out.header.length == 3u);
+        assert(out.flags == 0x7fu);
+        assert(out.value == 3.5);
+    }
+    {
+        // Flat types as elements of containers
+        std::vector<Header> headers{Header{1u, 2u, 3u}, Header{4u, 5u, 6u}};
+        auto bytes = toBytes(headers);
+        assert(bytes.size() == sizeof(std::size_t) + 2 * 16);
+
+        std::vector<Header> out;
+        crossbow::deserialize(out, bytes.data());
+        assert(out.size() == 2 && out[1].id == 4u && out[1].length == 6u);
+    }
+    {
+        NotFlat notFlat{5u, true};
+        auto bytes = toBytes(notFlat);
+        assert(bytes.size() == sizeof(uint32_t) + 1);
+    }
+    return 0;
+}
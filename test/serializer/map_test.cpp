@@ -0,0 +1,123 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Serializer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+// Custom hash map without reserve
+struct SimpleMap : std::map<uint32_t, std::string> {
+};
+
+template<class T, class U>
+void roundtrip(const T& in, U& out) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto size = crossbow::serialize(buffer, in);
+    auto end = crossbow::deserialize(out, buffer.get());
+    assert(end == buffer.get() + size);
+}
+
+} // anonymous namespace
+
+namespace crossbow {
+
+template<class Archiver>
+struct serialize_policy<Archiver, SimpleMap> : hash_map_serialize_policy<Archiver, SimpleMap> {
+};
+
+template<class Archiver>
+struct deserialize_policy<Archiver, SimpleMap> : hash_map_deserialize_policy<Archiver, SimpleMap> {
+};
+
+template<class Archiver>
+struct size_policy<Archiver, SimpleMap> : hash_map_size_policy<Archiver, SimpleMap> {
+};
+
+} // namespace crossbow
+
+int main() {
+    static_assert(crossbow::impl::has_reserve<std::unordered_map<int, int>>::value, "unordered_map has reserve");
+    static_assert(!crossbow::impl::has_reserve<SimpleMap>::value, "SimpleMap has no reserve");
+
+    {
+        std::unordered_map<uint64_t, std::string> in;
+        for (uint64_t i = 0; i < 10000; ++i) {
+            in.emplace(i, std::to_string(i));
+        }
+        std::unordered_map<uint64_t, std::string> out;
+        roundtrip(in, out);
+        assert(out == in);
+    }
+    {
+        std::map<std::string, uint32_t> in;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            in.emplace(std::to_string(i), i);
+        }
+        std::map<std::string, uint32_t> out;
+        roundtrip(in, out);
+        assert(out == in);
+    }
+    {
+        // Elements with equal keys keep their order
+        std::multimap<uint32_t, uint32_t> in;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            in.emplace(i % 10, i);
+        }
+        std::multimap<uint32_t, uint32_t> out;
+        roundtrip(in, out);
+        assert(out == in);
+    }
+    {
+        crossbow::concurrent_map<uint64_t, std::string> in;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            in.insert(i, std::to_string(i));
+        }
+        crossbow::concurrent_map<uint64_t, std::string> out;
+        roundtrip(in, out);
+        assert(out.size() == 1000);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            auto res = out.at(i);
+            assert(res.first && res.second == std::to_string(i));
+        }
+
+        // Serialized format is the same as for std::unordered_map
+        std::unordered_map<uint64_t, std::string> map;
+        roundtrip(in, map);
+        assert(map.size() == 1000 && map[999] == "999");
+    }
+    {
+        SimpleMap in;
+        in.emplace(1u, "one");
+        in.emplace(2u, "two");
+        SimpleMap out;
+        roundtrip(in, out);
+        assert(out == in);
+    }
+    return 0;
+}
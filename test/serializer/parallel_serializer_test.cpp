@@ -0,0 +1,81 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/Serializer.hpp>
+#include <crossbow/serializer/ParallelSerializer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+template<class T>
+std::vector<uint8_t> sequential(const T& obj) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto size = crossbow::serialize(buffer, obj);
+    return std::vector<uint8_t>(buffer.get(), buffer.get() + size);
+}
+
+template<class T>
+std::vector<uint8_t> parallel(const T& obj, unsigned numThreads, std::size_t minChunk) {
+    std::unique_ptr<uint8_t[]> buffer;
+    auto size = crossbow::parallel_serialize(buffer, obj, numThreads, minChunk);
+    return std::vector<uint8_t>(buffer.get(), buffer.get() + size);
+}
+
+} // anonymous namespace
+
+int main() {
+    std::vector<std::string> strings;
+    std::map<uint64_t, std::string> map;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> unorderedMap;
+    for (uint32_t i = 0; i < 10007; ++i) {
+        strings.emplace_back(i % 97, 'a' + (i % 26));
+        map.emplace(i * 7, std::to_string(i));
+        unorderedMap.emplace(i, std::vector<uint32_t>(i % 5, i));
+    }
+
+    for (unsigned numThreads : {1u, 2u, 3u, 8u}) {
+        assert(parallel(strings, numThreads, 100) == sequential(strings));
+        assert(parallel(map, numThreads, 100) == sequential(map));
+        assert(parallel(unorderedMap, numThreads, 100) == sequential(unorderedMap));
+    }
+
+    // Small containers are serialized sequentially
+    std::vector<uint64_t> small{1u, 2u, 3u};
+    assert(parallel(small, 4, 100) == sequential(small));
+
+    std::vector<uint64_t> empty;
+    assert(parallel(empty, 4, 1) == sequential(empty));
+
+    std::unique_ptr<uint8_t[]> buffer;
+    crossbow::parallel_serialize(buffer, map, 4, 10);
+    std::map<uint64_t, std::string> out;
+    crossbow::deserialize(out, buffer.get());
+    assert(out == map);
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+#include <crossbow/singleton.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace crossbow;
+
+namespace {
+
+std::atomic<int> gConstructed(0);
+std::atomic<int> gAlive(0);
+
+template<int Id>
+struct Counted {
+    Counted() : value(Id) {
+        // Make the construction window large enough for other threads to race on the first access
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ++gConstructed;
+        ++gAlive;
+    }
+
+    ~Counted() {
+        --gAlive;
+    }
+
+    int value;
+};
+
+/**
+ * @brief Starts the given number of threads which all access the singleton at the same time
+ */
+template<typename Singleton>
+void testFirstAccess(unsigned numThreads) {
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    std::vector<void*> instances(numThreads, nullptr);
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads.emplace_back([i, &start, &instances]() {
+            while (!start.load()) {
+            }
+            Singleton s;
+            for (int j = 0; j < 1000; ++j) {
+                assert(s->value >= 0);
+            }
+            instances[i] = &(*s);
+        });
+    }
+    start.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto instance : instances) {
+        assert(instance == &Singleton::instance());
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    using Shared = singleton<Counted<1>>;
+    testFirstAccess<Shared>(8);
+    assert(gConstructed == 1);
+    assert(Shared::instance().value == 1);
+
+    using Cached = singleton<Counted<2>, create_static<Counted<2>>, infinite_lifetime<Counted<2>>, std::mutex,
+            thread_local_access<Counted<2>>>;
+    testFirstAccess<Cached>(8);
+    assert(gConstructed == 2);
+    assert(Cached::instance().value == 2);
+
+    // A phoenix singleton is created again after it was destroyed
+    using Phoenix = singleton<Counted<3>, create_using_new<Counted<3>>, phoenix_lifetime<Counted<3>>>;
+    Phoenix::instance();
+    assert(gAlive == 3);
+    Phoenix::destroy_instance();
+    assert(gAlive == 2);
+    assert(Phoenix::instance().value == 3);
+    assert(gConstructed == 4);
+}
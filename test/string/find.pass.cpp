@@ -0,0 +1,138 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+
+// size_type find(const_pointer s, size_type pos, size_type count) const;
+// size_type rfind(const_pointer s, size_type pos, size_type count) const;
+// size_type find_first_of(const_pointer s, size_type pos, size_type count) const;
+// size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const;
+// size_type find_last_of(const_pointer s, size_type pos, size_type count) const;
+// size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const;
+
+#include <crossbow/string.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+using namespace crossbow;
+
+namespace {
+
+/**
+ * @brief Traits selecting the scalar search kernels
+ */
+struct scalar_traits : std::char_traits<char> {
+};
+
+uint64_t gState = 0x9E3779B97F4A7C15ull;
+
+size_t random(size_t bound) {
+    gState ^= gState << 13;
+    gState ^= gState >> 7;
+    gState ^= gState << 17;
+    return static_cast<size_t>(gState % bound);
+}
+
+template<class Traits>
+std::basic_string<char, Traits> randomString(size_t length, size_t alphabet) {
+    std::basic_string<char, Traits> res;
+    for (size_t i = 0; i < length; ++i) {
+        res.push_back(static_cast<char>('a' + random(alphabet)));
+    }
+    return res;
+}
+
+/**
+ * @brief Compares all search functions against the results of std::basic_string
+ */
+template<class Traits>
+void compare(const std::basic_string<char, Traits>& expected, const std::basic_string<char, Traits>& needle) {
+    using S = basic_string<char, Traits>;
+    S str(expected.data(), expected.size());
+    const char* s = needle.data();
+    auto count = needle.size();
+    size_t positions[] = {0, 1, random(expected.size() + 2), expected.size() - 1, expected.size(), expected.size() + 1,
+            S::npos};
+    for (auto pos : positions) {
+        assert(str.find(s, pos, count) == expected.find(s, pos, count));
+        assert(str.rfind(s, pos, count) == expected.rfind(s, pos, count));
+        assert(str.find_first_of(s, pos, count) == expected.find_first_of(s, pos, count));
+        assert(str.find_first_not_of(s, pos, count) == expected.find_first_not_of(s, pos, count));
+        assert(str.find_last_of(s, pos, count) == expected.find_last_of(s, pos, count));
+        assert(str.find_last_not_of(s, pos, count) == expected.find_last_not_of(s, pos, count));
+        if (count > 0) {
+            assert(str.find(needle[0], pos) == expected.find(needle[0], pos));
+            assert(str.rfind(needle[0], pos) == expected.rfind(needle[0], pos));
+            assert(str.find_first_of(needle[0], pos) == expected.find_first_of(needle[0], pos));
+            assert(str.find_first_not_of(needle[0], pos) == expected.find_first_not_of(needle[0], pos));
+            assert(str.find_last_of(needle[0], pos) == expected.find_last_of(needle[0], pos));
+            assert(str.find_last_not_of(needle[0], pos) == expected.find_last_not_of(needle[0], pos));
+        }
+    }
+}
+
+template<class Traits>
+void testRandom() {
+    for (int round = 0; round < 20000; ++round) {
+        auto alphabet = 1 + random(4);
+        auto haystack = randomString<Traits>(random(140), alphabet);
+        std::basic_string<char, Traits> needle;
+        if (!haystack.empty() && random(2) == 0) {
+            // Needles taken from the haystack, including matches at the very end
+            auto begin = random(haystack.size());
+            needle = haystack.substr(begin, random(40));
+        } else {
+            needle = randomString<Traits>(random(24), alphabet);
+        }
+        compare(haystack, needle);
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    {
+        // A match at the end of the string
+        string s("abcdef");
+        assert(s.find("ef") == 4);
+        assert(s.find("def", 3) == 3);
+        assert(s.find("f", 5) == 5);
+        assert(s.find("", 6) == 6);
+        assert(s.find("", 7) == string::npos);
+        assert(s.find("fg") == string::npos);
+        assert(s.find("abcdefg") == string::npos);
+    }
+    {
+        // Long haystacks exercise the vectorized loops
+        std::string expected(1000, 'a');
+        expected += "needle in a haystack";
+        expected += std::string(1000, 'a');
+        compare(expected, std::string("needle"));
+        compare(expected, std::string("needle in a haystack"));
+        compare(expected, std::string("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaan"));
+        compare(expected, std::string("xyz"));
+        compare(expected, std::string("a"));
+    }
+    testRandom<std::char_traits<char>>();
+    testRandom<scalar_traits>();
+}
@@ -0,0 +1,148 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+
+// size_t hash_value(const basic_string& str);
+
+#include <crossbow/string.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "min_allocator.h"
+
+using namespace crossbow;
+
+namespace {
+
+/**
+ * @brief Checks that all hashes are distinct and evenly distributed over the buckets selected by the lower bits
+ */
+void testDistribution(const std::vector<string>& keys) {
+    std::unordered_set<uint64_t> hashes;
+    hashes.reserve(keys.size());
+    const size_t numBuckets = 1 << 12;
+    std::vector<size_t> buckets(numBuckets, 0);
+    for (auto& key : keys) {
+        auto h = hash_value(key);
+        assert(hashes.insert(h).second);
+        ++buckets[h & (numBuckets - 1)];
+    }
+
+    // Chi-squared test with numBuckets - 1 degrees of freedom, the limit is about 5 standard deviations above the mean
+    auto expected = static_cast<double>(keys.size()) / numBuckets;
+    double chi = 0.0;
+    for (auto count : buckets) {
+        auto d = static_cast<double>(count) - expected;
+        chi += d * d / expected;
+    }
+    assert(chi < numBuckets + 5 * std::sqrt(2.0 * numBuckets));
+}
+
+/**
+ * @brief Checks that flipping a single input bit flips about half of the output bits
+ */
+void testAvalanche(size_t length) {
+    std::vector<unsigned char> key(length);
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    size_t flipped = 0;
+    size_t samples = 0;
+    for (int round = 0; round < 64; ++round) {
+        for (auto& c : key) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            c = static_cast<unsigned char>(state);
+        }
+        auto h = hash_bytes(key.data(), key.size());
+        for (size_t bit = 0; bit < length * 8; ++bit) {
+            key[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+            flipped += static_cast<size_t>(__builtin_popcountll(h ^ hash_bytes(key.data(), key.size())));
+            key[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+            ++samples;
+        }
+    }
+    auto average = static_cast<double>(flipped) / static_cast<double>(samples);
+    assert(average > 31.0 && average < 33.0);
+}
+
+} // anonymous namespace
+
+int main() {
+    // Equal strings have equal hashes independent of their storage
+    {
+        for (size_t length = 0; length < 100; ++length) {
+            std::string s(length, 'x');
+            string a(s.c_str());
+            basic_string<char, std::char_traits<char>, min_allocator<char>> b(s.c_str());
+            assert(hash_value(a) == hash_value(b));
+            assert(std::hash<string>()(a) == hash_value(a));
+            assert(hash_value(a) == hash_bytes(s.data(), s.size()));
+        }
+    }
+
+    // Prefixes and strings differing in a single character
+    {
+        std::vector<string> keys;
+        std::string s;
+        for (size_t length = 0; length < 300; ++length) {
+            keys.emplace_back(s.c_str());
+            s.push_back('a');
+        }
+        for (size_t length = 1; length < 70; ++length) {
+            for (size_t pos = 0; pos < length; ++pos) {
+                std::string t(length, 'a');
+                t[pos] = 'b';
+                keys.emplace_back(t.c_str());
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::unordered_set<size_t> hashes;
+        for (auto& key : keys) {
+            assert(hashes.insert(hash_value(key)).second);
+        }
+    }
+
+    // Sequential keys (short and long)
+    {
+        std::vector<string> keys;
+        for (size_t i = 0; i < 200000; ++i) {
+            keys.emplace_back(("key" + std::to_string(i)).c_str());
+        }
+        testDistribution(keys);
+        for (auto& key : keys) {
+            key = string("a rather long common prefix for all keys in the table ") + key;
+        }
+        testDistribution(keys);
+    }
+
+    for (size_t length : {1, 3, 4, 8, 15, 16, 17, 31, 48, 49, 100}) {
+        testAvalanche(length);
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+
+// class interned_string;
+
+#include <crossbow/interned_string.hpp>
+#include <crossbow/Serializer.hpp>
+#include <crossbow/serializer/interned_string.hpp>
+
+#include <cassert>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace crossbow;
+
+namespace {
+
+void testIdentity() {
+    interned_string empty;
+    assert(empty.empty());
+    assert(empty.size() == 0);
+    assert(empty.c_str()[0] == '\0');
+    assert(empty == interned_string(""));
+    assert(empty == interned_string(string()));
+    assert(empty.hash() == hash_value(string()));
+
+    string name("lineitem");
+    interned_string a(name);
+    interned_string b("lineitem");
+    interned_string c(std::string("lineitem"));
+    assert(a == b && b == c);
+    assert(a.data() == b.data());
+    assert(a.size() == 8);
+    assert(a.str() == name);
+    assert(a.hash() == hash_value(name));
+    assert(std::hash<interned_string>()(a) == std::hash<string>()(name));
+
+    // Embedded null characters are part of the string
+    interned_string d("line\0item", 9);
+    assert(d != a);
+    assert(d.size() == 9);
+
+    std::ostringstream out;
+    out << a;
+    assert(out.str() == "lineitem");
+}
+
+void testOrdering() {
+    std::set<interned_string> names;
+    for (auto s : {"orders", "lineitem", "customer", "order", "", "part"}) {
+        names.insert(interned_string(s));
+    }
+    std::vector<std::string> res;
+    for (auto& name : names) {
+        res.emplace_back(name.data(), name.size());
+    }
+    assert((res == std::vector<std::string>{"", "customer", "lineitem", "order", "orders", "part"}));
+}
+
+void testConcurrentInterning() {
+    const size_t numThreads = 8;
+    const size_t numStrings = 2000;
+    std::vector<std::vector<interned_string>> results(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t, &results]() {
+            for (size_t i = 0; i < numStrings; ++i) {
+                // Every thread interns the same strings in a different order
+                auto n = (i * (2 * t + 1)) % numStrings;
+                results[t].emplace_back(std::string("column_" + std::to_string(n)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::unordered_map<interned_string, size_t> index;
+    for (size_t i = 0; i < numStrings; ++i) {
+        index.emplace(results[0][i], i);
+    }
+    assert(index.size() == numStrings);
+    for (size_t t = 1; t < numThreads; ++t) {
+        for (size_t i = 0; i < numStrings; ++i) {
+            auto n = (i * (2 * t + 1)) % numStrings;
+            assert(results[t][i] == results[0][n]);
+            assert(results[t][i].data() == results[0][n].data());
+        }
+    }
+    assert(impl::intern_table_holder::instance().size() >= numStrings);
+}
+
+void testSerializer() {
+    interned_string in("an identifier");
+    sizer s;
+    s & in;
+    assert(s.size == sizeof(uint32_t) + in.size());
+    serializer ser(s.size);
+    ser & in;
+
+    // Interned strings use the same format as crossbow::string
+    string asString;
+    deserializer des1(ser.buffer.get());
+    des1 & asString;
+    assert(asString == "an identifier");
+
+    interned_string out;
+    deserializer des2(ser.buffer.get());
+    des2 & out;
+    assert(out == in);
+}
+
+} // anonymous namespace
+
+int main() {
+    testIdentity();
+    testOrdering();
+    testConcurrentInterning();
+    testSerializer();
+}
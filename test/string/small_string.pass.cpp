@@ -0,0 +1,117 @@
+/*
+ * (C) Copyright 2015 ETH Zurich Systems Group (http://www.systems.ethz.ch/) and others.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Contributors:
+ *     Markus Pilman <mpilman@inf.ethz.ch>
+ *     Simon Loesing <sloesing@inf.ethz.ch>
+ *     Thomas Etter <etterth@gmail.com>
+ *     Kevin Bocksrocker <kevin.bocksrocker@gmail.com>
+ *     Lucas Braun <braunl@inf.ethz.ch>
+ */
+
+// Small string boundary: strings of up to capacity() characters are stored inline and every
+// operation that crosses the boundary keeps size(), data() and the null terminator consistent.
+
+#include <crossbow/string.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "min_allocator.h"
+
+using namespace crossbow;
+
+namespace {
+
+template<class S>
+void checkString(const S& str, const std::string& expected) {
+    assert(str.size() == expected.size());
+    assert(str.capacity() >= str.size());
+    assert(std::memcmp(str.data(), expected.data(), expected.size()) == 0);
+    assert(str.c_str()[str.size()] == '\0');
+    assert(str.__invariants());
+}
+
+template<class S>
+void test() {
+    const std::size_t inlineCapacity = S().capacity();
+    assert(inlineCapacity == 31);
+
+    // Grow one character at a time over the boundary and shrink back
+    {
+        S str;
+        std::string expected;
+        for (std::size_t i = 0; i < inlineCapacity + 8; ++i) {
+            str.push_back(static_cast<char>('a' + i % 26));
+            expected.push_back(static_cast<char>('a' + i % 26));
+            checkString(str, expected);
+        }
+        while (!str.empty()) {
+            str.pop_back();
+            expected.pop_back();
+            checkString(str, expected);
+        }
+    }
+
+    for (std::size_t length = inlineCapacity - 2; length <= inlineCapacity + 2; ++length) {
+        std::string expected(length, 'x');
+        S str(expected.c_str());
+        checkString(str, expected);
+
+        S copy(str);
+        checkString(copy, expected);
+
+        S moved(std::move(copy));
+        checkString(moved, expected);
+        checkString(copy, "");
+
+        copy = std::move(moved);
+        checkString(copy, expected);
+        checkString(moved, "");
+
+        S other("y");
+        other.swap(copy);
+        checkString(other, expected);
+        checkString(copy, "y");
+
+        // Resize from and to the boundary
+        S resized("ab");
+        resized.resize(length, 'z');
+        checkString(resized, "ab" + std::string(length - 2, 'z'));
+        resized.resize(1);
+        checkString(resized, "a");
+
+        // Leave the inline buffer and come back
+        S shrunk(expected.c_str());
+        shrunk.reserve(100);
+        checkString(shrunk, expected);
+        shrunk.shrink_to_fit();
+        checkString(shrunk, expected);
+        assert(length > inlineCapacity || shrunk.capacity() == inlineCapacity);
+
+        shrunk.clear();
+        checkString(shrunk, "");
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    static_assert(sizeof(string) == 32, "the allocator must not add to the size of a string");
+    test<string>();
+    test<basic_string<char, std::char_traits<char>, min_allocator<char>>>();
+}